@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Convert a scheduler trace dump (CONFIG_APP_SCHED_TRACE) into a timeline.
+
+Reads a console capture holding the TRACE lines printed by sched_trace_dump(), from a serial port
+(needs pyserial), a file, or stdin, and writes the last complete dump as:
+
+    sched_trace.py capture.log -o trace.json     # Chrome JSON: open in ui.perfetto.dev
+    sched_trace.py capture.log --ctf trace_dir   # CTF 1.8: babeltrace2, Trace Compass
+    sched_trace.py /dev/ttyACM0 -o trace.json    # stops after the first dump
+
+Records are 8 bytes, little-endian: u32 cycle stamp, u8 event, u8 thread index, u16 argument; see
+src/sched_trace.h. Stamps are 32-bit and wrap, so gaps between consecutive records must be shorter
+than one wrap (about a minute at 64 MHz).
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+# enum sched_trace_event in src/sched_trace.h, by value.
+EVENTS = {
+    1: "thread_switched_in",
+    2: "thread_switched_out",
+    3: "isr_enter",
+    4: "isr_exit",
+    5: "fifo_put",
+    6: "fifo_get",
+    7: "event_set",
+    8: "event_wait",
+    9: "event_woke",
+    10: "sleep",
+    11: "woke",
+}
+SWITCH_IN, SWITCH_OUT, ISR_ENTER, ISR_EXIT = 1, 2, 3, 4
+
+THREAD_OTHER = 0xFF
+RECORD = struct.Struct("<IBBH")
+
+
+class Trace:
+    def __init__(self, hz, lost):
+        self.hz = hz
+        self.lost = lost
+        self.threads = {}  # index -> (priority, name)
+        self.records = []  # (cycles since the first record, event, thread, arg)
+
+    def thread_name(self, index):
+        if index == THREAD_OTHER:
+            return "other"
+        prio, name = self.threads.get(index, (None, f"thread{index}"))
+        return name if prio is None else f"{name} (prio {prio})"
+
+
+def parse(lines):
+    """Yield a Trace for every complete TRACE BEGIN ... TRACE END block."""
+    trace = None
+    raw = bytearray()
+    for line in lines:
+        start = line.find("TRACE ")
+        if start < 0:
+            continue
+        words = line[start:].split()
+        if len(words) < 2:
+            continue
+        if words[1] == "BEGIN":
+            fields = dict(word.split("=", 1) for word in words[2:] if "=" in word)
+            trace = Trace(int(fields["hz"]), int(fields.get("lost", 0)))
+            raw.clear()
+        elif trace is None:
+            continue
+        elif words[1] == "THREAD" and len(words) >= 4:
+            name = " ".join(words[4:]) or "?"
+            trace.threads[int(words[2])] = (int(words[3].split("=", 1)[1]), name)
+        elif words[1] == "DATA" and len(words) >= 3:
+            raw += bytes.fromhex(words[2])
+        elif words[1] == "END":
+            cycles = 0
+            prev = None
+            for offset in range(0, len(raw) - len(raw) % RECORD.size, RECORD.size):
+                stamp, event, thread, arg = RECORD.unpack_from(raw, offset)
+                if prev is not None:
+                    cycles += (stamp - prev) & 0xFFFFFFFF
+                prev = stamp
+                trace.records.append((cycles, event, thread, arg))
+            yield trace
+            trace = None
+
+
+def write_perfetto(trace, path):
+    """Chrome trace event JSON: one track per thread showing when it ran, one for ISRs."""
+    pid = 1
+    isr_tid = 0
+    out = [{"ph": "M", "name": "process_name", "pid": pid, "args": {"name": "zephyr"}},
+           {"ph": "M", "name": "thread_name", "pid": pid, "tid": isr_tid, "args": {"name": "ISR"}}]
+    seen = set()
+    running = set()  # tids with an open "running" slice
+    isr_depth = 0
+
+    for cycles, event, thread, arg in trace.records:
+        ts = cycles * 1e6 / trace.hz
+        tid = thread + 1
+        if tid not in seen:
+            seen.add(tid)
+            out.append({"ph": "M", "name": "thread_name", "pid": pid, "tid": tid,
+                        "args": {"name": trace.thread_name(thread)}})
+
+        if event == SWITCH_IN:
+            out.append({"ph": "B", "name": "running", "pid": pid, "tid": tid, "ts": ts})
+            running.add(tid)
+        elif event == SWITCH_OUT:
+            # A thread already running when the trace starts has no slice to end.
+            if tid in running:
+                out.append({"ph": "E", "pid": pid, "tid": tid, "ts": ts})
+                running.discard(tid)
+        elif event == ISR_ENTER:
+            out.append({"ph": "B", "name": "isr", "pid": pid, "tid": isr_tid, "ts": ts,
+                        "args": {"thread": trace.thread_name(thread)}})
+            isr_depth += 1
+        elif event == ISR_EXIT:
+            if isr_depth > 0:
+                out.append({"ph": "E", "pid": pid, "tid": isr_tid, "ts": ts})
+                isr_depth -= 1
+        else:
+            out.append({"ph": "i", "s": "t", "name": EVENTS.get(event, f"event{event}"),
+                        "pid": pid, "tid": tid, "ts": ts, "args": {"arg": arg}})
+
+    end = trace.records[-1][0] * 1e6 / trace.hz if trace.records else 0
+    out += [{"ph": "E", "pid": pid, "tid": tid, "ts": end} for tid in sorted(running)]
+    out += [{"ph": "E", "pid": pid, "tid": isr_tid, "ts": end}] * isr_depth
+
+    with open(path, "w", encoding="utf-8") as f:
+        json.dump({"traceEvents": out, "displayTimeUnit": "ns",
+                   "otherData": {"lost_records": trace.lost}}, f)
+
+
+CTF_METADATA = """/* CTF 1.8 */
+typealias integer {{ size = 8; align = 8; signed = false; }} := uint8_t;
+typealias integer {{ size = 16; align = 8; signed = false; }} := uint16_t;
+typealias integer {{ size = 32; align = 8; signed = false; }} := uint32_t;
+typealias integer {{ size = 64; align = 8; signed = false; }} := uint64_t;
+
+trace {{
+	major = 1;
+	minor = 8;
+	byte_order = le;
+	packet.header := struct {{
+		uint32_t magic;
+	}};
+}};
+
+clock {{
+	name = cycles;
+	freq = {hz};
+}};
+
+typealias integer {{ size = 64; align = 8; signed = false; map = clock.cycles.value; }} := cycles_t;
+
+stream {{
+	event.header := struct {{
+		uint8_t id;
+		cycles_t timestamp;
+	}};
+}};
+
+event {{
+	name = "thread_info";
+	id = 0;
+	fields := struct {{
+		uint8_t thread;
+		string name;
+	}};
+}};
+"""
+
+CTF_EVENT = """
+event {{
+	name = "{name}";
+	id = {id};
+	fields := struct {{
+		uint8_t thread;
+		uint16_t arg;
+	}};
+}};
+"""
+
+
+def write_ctf(trace, path):
+    """CTF 1.8 trace directory: thread_info events naming every thread, then the records."""
+    os.makedirs(path, exist_ok=True)
+    with open(os.path.join(path, "metadata"), "w", encoding="utf-8") as f:
+        f.write(CTF_METADATA.format(hz=trace.hz))
+        for event_id, name in sorted(EVENTS.items()):
+            f.write(CTF_EVENT.format(name=name, id=event_id))
+
+    stream = bytearray(struct.pack("<I", 0xC1FC1FC1))
+    for index in sorted(trace.threads):
+        stream += struct.pack("<BQB", 0, 0, index)
+        stream += trace.thread_name(index).encode() + b"\0"
+    for cycles, event, thread, arg in trace.records:
+        stream += struct.pack("<BQBH", event, cycles, thread, arg)
+    with open(os.path.join(path, "stream"), "wb") as f:
+        f.write(stream)
+
+
+def open_input(args):
+    if args.input == "-":
+        return sys.stdin
+    if args.input.startswith("/dev/") or args.input.upper().startswith("COM"):
+        import serial  # pylint: disable=import-outside-toplevel
+
+        port = serial.Serial(args.input, args.baud)
+        return (line.decode("ascii", errors="replace") for line in iter(port.readline, b""))
+    return open(args.input, encoding="ascii", errors="replace")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="serial port, console capture, or - for stdin")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("-o", "--output", help="write Chrome JSON for Perfetto here")
+    parser.add_argument("--ctf", metavar="DIR", help="write a CTF trace into this directory")
+    args = parser.parse_args()
+
+    if not args.output and not args.ctf:
+        parser.error("nothing to do: give -o and/or --ctf")
+
+    serial_port = args.input.startswith("/dev/") or args.input.upper().startswith("COM")
+    trace = None
+    for trace in parse(open_input(args)):
+        if serial_port:
+            break
+    if trace is None:
+        sys.exit("no complete TRACE BEGIN ... TRACE END block found")
+
+    if args.output:
+        write_perfetto(trace, args.output)
+    if args.ctf:
+        write_ctf(trace, args.ctf)
+    print(f"{len(trace.records)} records, {len(trace.threads)} threads"
+          + (f", {trace.lost} lost to overwriting" if trace.lost else ""), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
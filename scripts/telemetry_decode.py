@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Decode the binary telemetry stream (CONFIG_APP_TELEMETRY_FORMAT_BINARY) back into text.
+
+Reads from a serial port (needs pyserial), a file, or stdin:
+
+    telemetry_decode.py /dev/ttyACM0 [--baud 115200]
+    telemetry_decode.py capture.bin
+    telemetry_decode.py - < capture.bin
+
+Frames are COBS-encoded and end in 0x00; see src/telemetry_encode.h. Chunks that are not valid
+frames but are printable (the boot banner, error messages) are passed through as text.
+"""
+
+import argparse
+import sys
+
+# Message dictionary, mirroring enum telemetry_msg_id in src/telemetry_encode.h.
+MSG_TOGGLE = 1
+MSG_TOGGLE_DELTA = 2
+MSG_UART_STATS = 3
+MSG_TOGGLE_COALESCED = 4
+MSG_LED_STATS = 5
+MSG_LATENCY = 6
+MSG_CPU_LOAD = 7
+MSG_LED_WAKEUPS = 8
+MSG_BOOT = 9
+MSG_LED_TIMING = 10
+MSG_LED_WORK = 11
+MSG_SCENARIO_LED = 12
+MSG_SCENARIO_UART = 13
+MSG_SCENARIO_RATE = 14
+MSG_BUSY_PROBE = 15
+MSG_LED1_WAKE = 16
+MSG_BUTTON = 17
+MSG_BUTTON_BUCKET = 18
+
+# enum latency_stage in src/latency.h.
+LATENCY_STAGES = ["dequeue", "tx_done"]
+# enum led_scenario in src/leds.h, by value.
+SCENARIOS = ["none", "high_busy", "equal_yield", "low_yield", "equal_noyield", "low_noyield"]
+
+FORMATS = {
+    MSG_TOGGLE: "Toggled led{0}; counter={1}",
+    MSG_TOGGLE_DELTA: "Toggled led{0}; counter={1}",
+    MSG_UART_STATS: "uart: {0} lines/s, {1} ns/line",
+    MSG_TOGGLE_COALESCED: "Toggled led{0}; counter={1} ({2} coalesced)",
+    MSG_LED_STATS: "led{0}: sent={1} dropped={2} nomem={3} depth={4}/{5}",
+    MSG_LATENCY: "latency led{0} {1}: n={2} p50={3}us p99={4}us max={5}us",
+    MSG_CPU_LOAD: "cpu thread{0}: {1}% switches={2}",
+    MSG_LED_WAKEUPS: "leds: {0} wakeups/s for {1} toggles/s",
+    MSG_BOOT: "boot: reset->main={0}us main->configured={1}us configured->toggle={2}us",
+    MSG_LED_TIMING: "led{0}: periods={1} missed={2} max_late={3}us",
+    MSG_LED_WORK: "led_workq: depth={0}/{1} max_runtime={2}us",
+    MSG_SCENARIO_LED: "scenario led{0}: toggles={1} max_gap={2}ms",
+    MSG_SCENARIO_UART: "scenario uart: p99={0}us max={1}us",
+    MSG_SCENARIO_RATE: "scenario {0}: led3 {1} toggles/s",
+    MSG_BUSY_PROBE: "probe: {0} toggles/s ({1}-{2}), {3}% taken",
+    MSG_LED1_WAKE: "led1 wake via {0}: n={1} avg={2}us max={3}us",
+    MSG_BUTTON: "button: n={0} p50={1}us p99={2}us max={3}us",
+    MSG_BUTTON_BUCKET: "button {0}-{1}us: {2}",
+}
+
+
+def crc8_ccitt(data, crc=0):
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS block")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def varints(data):
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            yield value
+            value = shift = 0
+    if shift:
+        raise ValueError("truncated varint")
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+class Decoder:
+    def __init__(self):
+        self.counters = {}  # led -> last counter, for delta messages
+        self.bad_frames = 0
+
+    def frame(self, chunk):
+        """Return the text for one 0x00-terminated chunk (without the terminator), or None."""
+        try:
+            raw = cobs_decode(chunk)
+            if len(raw) < 2 or crc8_ccitt(raw[:-1]) != raw[-1]:
+                raise ValueError("bad CRC")
+            msg_id, args = raw[0], list(varints(raw[1:-1]))
+            if msg_id not in FORMATS:
+                raise ValueError(f"unknown message {msg_id}")
+        except ValueError:
+            text = chunk.decode("ascii", errors="replace")
+            if chunk and all(32 <= b < 127 or b in b"\r\n\t" for b in chunk):
+                return text.rstrip("\r\n")
+            self.bad_frames += 1
+            return None
+
+        if msg_id in (MSG_TOGGLE, MSG_TOGGLE_COALESCED):
+            self.counters[args[0]] = args[1]
+        elif msg_id == MSG_TOGGLE_DELTA:
+            if args[0] not in self.counters:
+                return None  # joined mid-stream; wait for the next keyframe
+            args[1] = (self.counters[args[0]] + unzigzag(args[1])) & 0xFFFFFFFF
+            self.counters[args[0]] = args[1]
+        elif msg_id == MSG_LATENCY and args[1] < len(LATENCY_STAGES):
+            args[1] = LATENCY_STAGES[args[1]]
+        elif msg_id == MSG_CPU_LOAD:
+            args[1] = f"{args[1] // 10}.{args[1] % 10}"
+        elif msg_id == MSG_SCENARIO_RATE and args[0] < len(SCENARIOS):
+            args[0] = SCENARIOS[args[0]]
+        elif msg_id == MSG_LED1_WAKE:
+            args[0] = "edge" if args[0] else "events"
+        return FORMATS[msg_id].format(*args)
+
+
+def open_input(args):
+    if args.input == "-":
+        return sys.stdin.buffer
+    if args.input.startswith("/dev/") or args.input.upper().startswith("COM"):
+        import serial  # pylint: disable=import-outside-toplevel
+
+        return serial.Serial(args.input, args.baud)
+    return open(args.input, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="serial port, capture file, or - for stdin")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    decoder = Decoder()
+    stream = open_input(args)
+    chunk = bytearray()
+    try:
+        while True:
+            data = stream.read(1)
+            if not data:
+                break
+            if data[0] != 0:
+                chunk += data
+                continue
+            text = decoder.frame(bytes(chunk))
+            chunk.clear()
+            if text is not None:
+                print(text, flush=True)
+    except KeyboardInterrupt:
+        pass
+    if decoder.bad_frames:
+        print(f"# {decoder.bad_frames} corrupt frames skipped", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
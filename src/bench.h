@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_BENCH_H_
+#define APP_BENCH_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+
+/* Benchmarks print one line per result so they can be scraped from the console:
+ *
+ *   BENCH <name> ops=<n> cycles=<total> cycles_per_op=<total/n> ns_per_op=<ns>
+ *
+ * Benchmarks call timing_init()/timing_start() but never timing_stop(): other users of the timing
+ * API (such as the UART statistics) may still be running.
+ */
+static inline void bench_report(const char *name, uint32_t ops, uint64_t cycles)
+{
+	uint64_t ns = timing_cycles_to_ns(cycles);
+
+	printk("BENCH %s ops=%u cycles=%llu cycles_per_op=%llu ns_per_op=%llu\n", name, ops,
+	       cycles, ops ? cycles / ops : 0, ops ? ns / ops : 0);
+}
+
+#ifdef CONFIG_APP_BENCH_SCHED
+/* Kernel benchmark image only: scheduler and wait queue costs as the thread count grows, with
+ * @iterations operations per result. */
+void sched_bench(uint32_t iterations);
+#endif
+
+#ifdef CONFIG_APP_BENCH_ZBUS
+/* Kernel benchmark image only: LED state over zbus against events + k_fifo, from 4 and 64
+ * publisher threads, with @iterations messages per result. */
+void zbus_bench(uint32_t iterations);
+#endif
+
+#endif /* APP_BENCH_H_ */
@@ -0,0 +1,33 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "boot_phase.h"
+
+static uint32_t stamps[BOOT_PHASES];
+static ATOMIC_DEFINE(marked, BOOT_PHASES);
+static ATOMIC_DEFINE(valid, BOOT_PHASES);
+
+void boot_phase_mark(enum boot_phase phase)
+{
+	uint32_t now = k_cycle_get_32();
+
+	if (phase >= BOOT_PHASES || atomic_test_bit(marked, phase) ||
+	    atomic_test_and_set_bit(marked, phase)) {
+		return;
+	}
+	stamps[phase] = now;
+	atomic_set_bit(valid, phase);
+}
+
+bool boot_phase_us(enum boot_phase phase, uint32_t *us)
+{
+	if (phase >= BOOT_PHASES || !atomic_test_bit(valid, phase)) {
+		return false;
+	}
+	*us = k_cyc_to_us_floor32(stamps[phase]);
+	return true;
+}
@@ -0,0 +1,26 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_BOOT_PHASE_H_
+#define APP_BOOT_PHASE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Boot milestones, timestamped with the cycle counter. The counter starts with the system timer,
+ * which is as close to reset as the kernel can measure. */
+enum boot_phase {
+	BOOT_PHASE_MAIN,         /* init() started */
+	BOOT_PHASE_CONFIGURED,   /* LED pins configured, EVENT_INIT_DONE about to be set */
+	BOOT_PHASE_FIRST_TOGGLE, /* an LED engine toggled its first LED */
+	BOOT_PHASES,
+};
+
+/* Record @phase. Only the first call per phase counts, so this is cheap to leave in loops. */
+void boot_phase_mark(enum boot_phase phase);
+
+/* Returns true and the microseconds since the counter started if @phase has been reached. */
+bool boot_phase_us(enum boot_phase phase, uint32_t *us);
+
+#endif /* APP_BOOT_PHASE_H_ */
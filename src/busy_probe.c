@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "busy_probe.h"
+#include "leds.h"
+
+#define BUSY_LED 3
+
+static struct k_spinlock lock;
+static uint32_t last_toggles;
+static uint32_t best; /* fastest sample since boot */
+static struct {
+	uint32_t samples;
+	uint64_t sum;
+	uint32_t min;
+	uint32_t max;
+} acc = {.min = UINT32_MAX};
+
+/* Runs in the system clock ISR: one counter read and a few adds per sample. */
+static void sample(struct k_timer *timer)
+{
+	struct led_activity act;
+	uint32_t rate;
+	k_spinlock_key_t key;
+
+	led_activity_get(BUSY_LED, &act);
+	// Millions of toggles a second from the busy loop overflow 32 bits once multiplied.
+	rate = (uint64_t)(act.toggles - last_toggles) * MSEC_PER_SEC /
+	       CONFIG_APP_BUSY_PROBE_SAMPLE_MS;
+	last_toggles = act.toggles;
+
+	key = k_spin_lock(&lock);
+	acc.samples++;
+	acc.sum += rate;
+	acc.min = MIN(acc.min, rate);
+	acc.max = MAX(acc.max, rate);
+	best = MAX(best, rate);
+	k_spin_unlock(&lock, key);
+}
+
+static K_TIMER_DEFINE(sample_timer, sample, NULL);
+
+void busy_probe_summary_get(struct busy_probe_summary *summary)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	summary->samples = acc.samples;
+	summary->avg = acc.samples ? acc.sum / acc.samples : 0;
+	summary->min = acc.samples ? acc.min : 0;
+	summary->max = acc.max;
+	summary->taken_pct = best ? (best - MIN(summary->avg, best)) * 100 / best : 0;
+	acc.samples = 0;
+	acc.sum = 0;
+	acc.min = UINT32_MAX;
+	acc.max = 0;
+	k_spin_unlock(&lock, key);
+}
+
+static int busy_probe_init(void)
+{
+	k_timer_start(&sample_timer, K_MSEC(CONFIG_APP_BUSY_PROBE_SAMPLE_MS),
+		      K_MSEC(CONFIG_APP_BUSY_PROBE_SAMPLE_MS));
+	return 0;
+}
+SYS_INIT(busy_probe_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,25 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_BUSY_PROBE_H_
+#define APP_BUSY_PROBE_H_
+
+#include <stdint.h>
+
+/* LED3's busy loop as a measure of spare CPU: it only runs when nothing of higher priority wants
+ * to, so its toggle rate drops by however much the other threads and ISRs take. A k_timer samples
+ * the loop's counter every CONFIG_APP_BUSY_PROBE_SAMPLE_MS; the loop itself does nothing extra.
+ */
+struct busy_probe_summary {
+	uint32_t samples;   /* since the previous busy_probe_summary_get() */
+	uint32_t avg;       /* toggles/s over those samples */
+	uint32_t min;       /* toggles/s in the slowest sample */
+	uint32_t max;       /* toggles/s in the fastest sample */
+	uint32_t taken_pct; /* avg below the fastest sample since boot, as a share of it */
+};
+
+/* Summarise the samples taken since the previous call, and start a new summary. */
+void busy_probe_summary_get(struct busy_probe_summary *summary);
+
+#endif /* APP_BUSY_PROBE_H_ */
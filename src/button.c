@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+
+#if CONFIG_APP_BUTTON_INJECT_MS > 0
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#endif
+
+#include "button.h"
+#include "leds.h"
+#include "threads.h"
+
+static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios);
+static struct gpio_callback button_cb;
+
+static K_SEM_DEFINE(pressed, 0, 1);
+
+/* k_cycle_get_32() at the latest interrupt entry. A nested interrupt between the GPIO one's entry
+ * and its callback moves it later, understating that press. */
+static volatile uint32_t isr_entry;
+
+/* isr_entry as the callback saw it for the pending press, or 0 if none is pending. */
+static atomic_t pending;
+
+static struct latency_histogram hist;
+static struct k_spinlock lock;
+
+void button_isr_entered(void)
+{
+	isr_entry = k_cycle_get_32();
+}
+
+static void button_pressed(const struct device *port, struct gpio_callback *cb, uint32_t pins)
+{
+	// Bit 0 set so a stamp is never 0; one cycle is well below the histogram's resolution.
+	uint32_t stamp = isr_entry | 1;
+
+	if (atomic_cas(&pending, 0, stamp)) {
+		k_sem_give(&pressed);
+	}
+}
+
+void button_latency_get(struct latency_histogram *h)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*h = hist;
+	k_spin_unlock(&lock, key);
+}
+
+#if CONFIG_APP_BUTTON_INJECT_MS > 0
+/* Press and release: only the press raises an interrupt. */
+static void inject(struct k_timer *timer)
+{
+	int active = (button.dt_flags & GPIO_ACTIVE_LOW) ? 0 : 1;
+
+	gpio_emul_input_set(button.port, button.pin, active);
+	gpio_emul_input_set(button.port, button.pin, !active);
+}
+
+static K_TIMER_DEFINE(inject_timer, inject, NULL);
+#endif
+
+static int button_setup(void)
+{
+	int ret;
+
+	if (!gpio_is_ready_dt(&button)) {
+		printk("Error: %s device is not ready\n", button.port->name);
+		return -ENODEV;
+	}
+	ret = gpio_pin_configure_dt(&button, GPIO_INPUT);
+	if (ret == 0) {
+		ret = gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_TO_ACTIVE);
+	}
+	if (ret == 0) {
+		gpio_init_callback(&button_cb, button_pressed, BIT(button.pin));
+		ret = gpio_add_callback_dt(&button, &button_cb);
+	}
+	if (ret != 0) {
+		printk("Error %d: failed to configure pin %d (button)\n", ret, button.pin);
+	}
+	return ret;
+}
+
+static void button_thread(void)
+{
+	if (button_setup() != 0) {
+		return;
+	}
+#if CONFIG_APP_BUTTON_INJECT_MS > 0
+	k_timer_start(&inject_timer, K_MSEC(CONFIG_APP_BUTTON_INJECT_MS),
+		      K_MSEC(CONFIG_APP_BUTTON_INJECT_MS));
+#endif
+
+	while (1) {
+		k_spinlock_key_t key;
+		uint32_t us;
+
+		k_sem_take(&pressed, K_FOREVER);
+		us = k_cyc_to_us_floor32(k_cycle_get_32() - (uint32_t)atomic_set(&pending, 0));
+
+		(void)led_toggle(CONFIG_APP_BUTTON_LED);
+
+		key = k_spin_lock(&lock);
+		latency_histogram_add(&hist, us);
+		k_spin_unlock(&lock, key);
+	}
+}
+
+K_THREAD_DEFINE(button_id, STACKSIZE, button_thread, NULL, NULL, NULL,
+		PRIORITY_LEDS + CONFIG_APP_BUTTON_PRIORITY_OFFSET, 0, 0);
@@ -0,0 +1,34 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_BUTTON_H_
+#define APP_BUTTON_H_
+
+#include "latency.h"
+
+/* The sw0 button (CONFIG_APP_BUTTON). The ISR tracing hook stamps k_cycle_get_32() on every
+ * interrupt entry; the GPIO callback keeps the stamp of the interrupt it runs in and gives a
+ * semaphore, and a thread at PRIORITY_LEDS + CONFIG_APP_BUTTON_PRIORITY_OFFSET takes it and toggles
+ * CONFIG_APP_BUTTON_LED. The time from interrupt entry to that thread running (interrupt entry, the
+ * GPIO driver's dispatch, the wakeup and any preemption) goes into a histogram, so it shows what
+ * the load around it (LED3's busy loop, uart_out(), the blink threads) costs an interrupt-driven
+ * wakeup. Presses that arrive while one is still pending are coalesced with it.
+ *
+ * On native_sim, boards/native_sim.overlay puts sw0 on the emulated GPIO controller and a k_timer
+ * presses it every CONFIG_APP_BUTTON_INJECT_MS.
+ */
+
+/* Copy the wakeup latency histogram. */
+void button_latency_get(struct latency_histogram *h);
+
+#ifdef CONFIG_APP_BUTTON
+/* Tracing hook (see trace_hooks.c): an interrupt was entered. */
+void button_isr_entered(void);
+#else
+static inline void button_isr_entered(void)
+{
+}
+#endif
+
+#endif /* APP_BUTTON_H_ */
@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "coro.h"
+
+void coro_exec_init(struct coro_exec *exec, struct coro **tasks, size_t len)
+{
+	exec->tasks = tasks;
+	exec->len = len;
+	k_sem_init(&exec->kick, 0, 1);
+}
+
+void coro_init(struct coro *co, coro_fn_t fn, uint32_t when)
+{
+	co->fn = fn;
+	co->due = when;
+	co->lc = 0;
+	co->state = CORO_SLEEPING;
+}
+
+/* A linear scan rather than a heap: a pass that resumes anything resumes everything that is due,
+ * so LEDs sharing deadlines cost one scan between them, and a task costs no more than its struct
+ * coro and one pointer. */
+int64_t coro_exec_pass(struct coro_exec *exec, uint32_t *resumed)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+
+	*resumed = 0;
+	for (size_t i = 0; i < exec->len; i++) {
+		struct coro *co = exec->tasks[i];
+		int32_t left;
+
+		if (co->state == CORO_DONE) {
+			continue;
+		}
+		if (co->state == CORO_SLEEPING) {
+			left = co->due - (uint32_t)now;
+			if (left > 0) {
+				next = MIN(next, now + left);
+				continue;
+			}
+		}
+
+		co->state = co->fn(co);
+		(*resumed)++;
+
+		switch (co->state) {
+		case CORO_READY:
+			next = now;
+			break;
+		case CORO_SLEEPING:
+			left = co->due - (uint32_t)now;
+			next = MIN(next, now + MAX(left, 0));
+			break;
+		default:
+			break;
+		}
+	}
+	return next;
+}
+
+FUNC_NORETURN void coro_exec_run(struct coro_exec *exec)
+{
+	while (1) {
+		uint32_t resumed;
+		int64_t next = coro_exec_pass(exec, &resumed);
+
+		if (next <= k_uptime_get()) {
+			// Something is ready now: give threads of the same priority a turn first, as a
+			// thread that yielded would.
+			k_yield();
+		} else {
+			(void)k_sem_take(&exec->kick,
+					 next == INT64_MAX ? K_FOREVER : K_TIMEOUT_ABS_MS(next));
+		}
+	}
+}
+
+void coro_exec_kick(struct coro_exec *exec)
+{
+	k_sem_give(&exec->kick);
+}
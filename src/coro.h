@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_CORO_H_
+#define APP_CORO_H_
+
+#include <zephyr/kernel.h>
+
+/* Stackless tasks: each is a function that runs until its next CORO_YIELD(), CORO_SLEEP_UNTIL()
+ * or CORO_WAIT_UNTIL() and returns, to be resumed from that point on its next call. A task is a
+ * struct coro (12 bytes on 32-bit targets) plus whatever state it needs, and one executor thread
+ * runs any number of them.
+ *
+ * The resume point is a switch case (protothread style), so locals don't survive a yield: keep
+ * state in a struct that embeds the struct coro and get it back with CONTAINER_OF(). A task must
+ * not use switch statements spanning a yield, and must not block: any kernel call that can sleep
+ * stalls every task on the executor.
+ *
+ *   static enum coro_state blink(struct coro *co)
+ *   {
+ *           struct blink_task *t = CONTAINER_OF(co, struct blink_task, co);
+ *
+ *           CORO_BEGIN(co);
+ *           while (1) {
+ *                   toggle(t);
+ *                   CORO_SLEEP_UNTIL(co, co->due + t->period_ms);
+ *           }
+ *           CORO_END(co);
+ *   }
+ */
+
+enum coro_state {
+	CORO_READY,    /* run again on the executor's next pass */
+	CORO_SLEEPING, /* run again once uptime reaches due */
+	CORO_WAITING,  /* run again on every pass, to re-check its condition */
+	CORO_DONE,
+};
+
+struct coro;
+typedef enum coro_state (*coro_fn_t)(struct coro *co);
+
+struct coro {
+	coro_fn_t fn;
+	uint32_t due; /* k_uptime_get_32() at which a CORO_SLEEPING task resumes */
+	uint16_t lc;  /* resume point: 0 for the start, otherwise a line number */
+	uint8_t state;
+};
+
+#define CORO_BEGIN(co)                                                                             \
+	switch ((co)->lc) {                                                                        \
+	case 0:
+
+#define CORO_END(co)                                                                               \
+	}                                                                                          \
+	(co)->lc = 0;                                                                              \
+	return CORO_DONE
+
+/* Let the other tasks run, then carry on. */
+#define CORO_YIELD(co)                                                                             \
+	do {                                                                                       \
+		(co)->lc = __LINE__;                                                               \
+		return CORO_READY;                                                                 \
+	case __LINE__:;                                                                            \
+	} while (0)
+
+/* Resume once k_uptime_get_32() reaches @when. Advancing co->due by a period gives absolute
+ * deadlines, like period_wait(). */
+#define CORO_SLEEP_UNTIL(co, when)                                                                 \
+	do {                                                                                       \
+		(co)->due = (when);                                                                \
+		(co)->lc = __LINE__;                                                               \
+		return CORO_SLEEPING;                                                              \
+	case __LINE__:;                                                                            \
+	} while (0)
+
+/* Resume once @cond is true. It is evaluated on every executor pass, so whatever makes it true
+ * from outside the executor should call coro_exec_kick(). */
+#define CORO_WAIT_UNTIL(co, cond)                                                                  \
+	do {                                                                                       \
+		(co)->lc = __LINE__;                                                               \
+	case __LINE__:                                                                             \
+		if (!(cond)) {                                                                     \
+			return CORO_WAITING;                                                       \
+		}                                                                                  \
+	} while (0)
+
+/* Runs the tasks in @tasks, in array order on each pass. */
+struct coro_exec {
+	struct coro **tasks;
+	size_t len;
+	struct k_sem kick;
+};
+
+void coro_exec_init(struct coro_exec *exec, struct coro **tasks, size_t len);
+
+/* Prepare @co to start at @fn once uptime reaches @when (ms). */
+void coro_init(struct coro *co, coro_fn_t fn, uint32_t when);
+
+/* Resume every task that is ready, due or waiting, once each, and count them in @resumed.
+ * Returns the uptime (ms) the next pass is due: now if a task is ready to run again, INT64_MAX if
+ * only a coro_exec_kick() can make one ready. */
+int64_t coro_exec_pass(struct coro_exec *exec, uint32_t *resumed);
+
+/* Run passes forever, sleeping between them while no task is ready. */
+FUNC_NORETURN void coro_exec_run(struct coro_exec *exec);
+
+/* Wake the executor to re-check its waiting tasks. Callable from ISRs. */
+void coro_exec_kick(struct coro_exec *exec);
+
+#ifdef CONFIG_APP_BENCH_CORO
+/* Time executor passes over CONFIG_APP_BENCH_CORO_TASKS yielding tasks. */
+void coro_bench(void);
+#endif
+
+#endif /* APP_CORO_H_ */
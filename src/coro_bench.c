@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "bench.h"
+#include "coro.h"
+#include "threads.h"
+
+#ifdef CONFIG_APP_BENCH_CORO
+struct bench_task {
+	struct coro co;
+	uint32_t cnt;
+};
+
+static struct bench_task bench_tasks[CONFIG_APP_BENCH_CORO_TASKS];
+static struct coro *bench_coros[ARRAY_SIZE(bench_tasks)];
+
+static enum coro_state bench_step(struct coro *co)
+{
+	struct bench_task *t = CONTAINER_OF(co, struct bench_task, co);
+
+	CORO_BEGIN(co);
+	while (1) {
+		t->cnt++;
+		CORO_YIELD(co);
+	}
+	CORO_END(co);
+}
+
+/* Every task yields on every step, so each pass resumes all of them: the cost per step is the
+ * executor's dispatch overhead plus one increment. */
+void coro_bench(void)
+{
+	const size_t task_bytes = sizeof(struct bench_task) + sizeof(struct coro *);
+	const size_t thread_bytes = STACKSIZE + sizeof(struct k_thread);
+	struct coro_exec exec;
+	uint32_t steps = 0;
+	timing_t start, end;
+
+	timing_init();
+	timing_start();
+
+	for (size_t i = 0; i < ARRAY_SIZE(bench_tasks); i++) {
+		coro_init(&bench_tasks[i].co, bench_step, 0);
+		bench_coros[i] = &bench_tasks[i].co;
+	}
+	coro_exec_init(&exec, bench_coros, ARRAY_SIZE(bench_coros));
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < CONFIG_APP_BENCH_ITERATIONS; i++) {
+		uint32_t resumed;
+
+		(void)coro_exec_pass(&exec, &resumed);
+		steps += resumed;
+	}
+	end = timing_counter_get();
+	bench_report("coro_step", steps, timing_cycles_get(&start, &end));
+
+	printk("BENCH coro_ram tasks=%u bytes_per_task=%u thread_bytes=%u tasks_per_thread=%u\n",
+	       (uint32_t)ARRAY_SIZE(bench_tasks), (uint32_t)task_bytes, (uint32_t)thread_bytes,
+	       (uint32_t)(thread_bytes / task_bytes));
+}
+#endif /* CONFIG_APP_BENCH_CORO */
@@ -0,0 +1,150 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+
+#include "cpu_load.h"
+
+struct slot {
+	k_tid_t tid;
+	bool seen;
+	uint64_t last_cycles;
+	atomic_t switches;
+	uint32_t last_switches;
+	struct cpu_load load;
+};
+
+static struct slot slots[CONFIG_APP_CPU_LOAD_MAX_THREADS];
+static struct k_spinlock lock;
+static uint64_t last_total;
+
+static void sample_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(sample_work, sample_work_handler);
+
+static struct slot *slot_find(const struct k_thread *thread)
+{
+	for (uint32_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (slots[i].tid == thread) {
+			return &slots[i];
+		}
+	}
+	return NULL;
+}
+
+#ifdef CONFIG_APP_CPU_LOAD_SWITCHES
+void cpu_load_switched_in(void)
+{
+	struct slot *slot = slot_find(k_current_get());
+
+	if (slot != NULL) {
+		atomic_inc(&slot->switches);
+	}
+}
+#endif
+
+static void sample_thread(const struct k_thread *thread, void *user_data)
+{
+	uint64_t window = *(uint64_t *)user_data;
+	k_tid_t tid = (k_tid_t)thread;
+	struct slot *slot = slot_find(thread);
+	k_thread_runtime_stats_t stats;
+	k_spinlock_key_t key;
+	const char *name;
+	uint32_t switches;
+
+	if (slot == NULL) {
+		/* New thread: claim a free slot and start measuring from the next window. */
+		slot = slot_find(NULL);
+		if (slot == NULL || k_thread_runtime_stats_get(tid, &stats) != 0) {
+			return;
+		}
+		key = k_spin_lock(&lock);
+		slot->load = (struct cpu_load){0};
+		k_spin_unlock(&lock, key);
+		atomic_set(&slot->switches, 0);
+		slot->last_switches = 0;
+		slot->last_cycles = stats.execution_cycles;
+		slot->seen = true;
+		slot->tid = tid;
+		return;
+	}
+
+	if (k_thread_runtime_stats_get(tid, &stats) != 0) {
+		return;
+	}
+	switches = atomic_get(&slot->switches);
+	name = k_thread_name_get(tid);
+
+	key = k_spin_lock(&lock);
+	slot->load.name = (name != NULL && name[0] != '\0') ? name : "?";
+	slot->load.permille =
+		window ? (uint32_t)((stats.execution_cycles - slot->last_cycles) * 1000 / window) : 0;
+	slot->load.switches = switches - slot->last_switches;
+	k_spin_unlock(&lock, key);
+	slot->last_cycles = stats.execution_cycles;
+	slot->last_switches = switches;
+	slot->seen = true;
+}
+
+static void sample_work_handler(struct k_work *work)
+{
+	k_thread_runtime_stats_t all;
+	uint64_t window;
+
+	k_thread_runtime_stats_all_get(&all);
+	window = all.execution_cycles - last_total;
+	last_total = all.execution_cycles;
+
+	k_thread_foreach_unlocked(sample_thread, &window);
+
+	/* Free the slots of threads that have exited. */
+	for (uint32_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].seen) {
+			slots[i].tid = NULL;
+		}
+		slots[i].seen = false;
+	}
+
+	k_work_schedule(&sample_work, K_MSEC(CONFIG_APP_CPU_LOAD_WINDOW_MS));
+}
+
+static int cpu_load_setup(void)
+{
+	k_work_schedule(&sample_work, K_NO_WAIT);
+	return 0;
+}
+SYS_INIT(cpu_load_setup, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+int cpu_load_get(uint32_t slot, struct cpu_load *load)
+{
+	k_spinlock_key_t key;
+	int ret = -ENOENT;
+
+	if (slot >= ARRAY_SIZE(slots)) {
+		return -ENOENT;
+	}
+
+	key = k_spin_lock(&lock);
+	if (slots[slot].tid != NULL && slots[slot].load.name != NULL) {
+		*load = slots[slot].load;
+		ret = 0;
+	}
+	k_spin_unlock(&lock, key);
+	return ret;
+}
+
+void cpu_load_dump(void)
+{
+	struct cpu_load load;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (cpu_load_get(i, &load) == 0) {
+			printk("cpu %s: %u.%u%% switches=%u\n", load.name, load.permille / 10,
+			       load.permille % 10, load.switches);
+		}
+	}
+}
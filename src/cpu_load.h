@@ -0,0 +1,33 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_CPU_LOAD_H_
+#define APP_CPU_LOAD_H_
+
+#include <stdint.h>
+
+/* Per-thread CPU load, from the kernel's thread runtime statistics. Every
+ * CONFIG_APP_CPU_LOAD_WINDOW_MS the system workqueue samples all threads; results describe the
+ * most recent complete window. Threads are tracked in slots 0 to CONFIG_APP_CPU_LOAD_MAX_THREADS - 1
+ * in the order they were first seen, and keep their slot until they exit.
+ */
+struct cpu_load {
+	const char *name;  /* thread name, or "?" if it has none */
+	uint32_t permille; /* share of the window's cycles, idle thread included */
+	uint32_t switches; /* times the thread was switched in (CONFIG_APP_CPU_LOAD_SWITCHES) */
+};
+
+/* Returns 0, or -ENOENT if no thread occupies @slot. */
+int cpu_load_get(uint32_t slot, struct cpu_load *load);
+
+/* printk() the load of every tracked thread. */
+void cpu_load_dump(void);
+
+#ifdef CONFIG_APP_CPU_LOAD_SWITCHES
+/* Tracing hook (see trace_hooks.c), called on every context switch with the incoming thread as
+ * current. */
+void cpu_load_switched_in(void);
+#endif
+
+#endif /* APP_CPU_LOAD_H_ */
@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "edge.h"
+
+void edge_subscribe(struct edge *e, struct edge_sub *sub)
+{
+	k_spinlock_key_t key;
+
+	k_sem_init(&sub->sem, 0, 1);
+	key = k_spin_lock(&e->lock);
+	sub->seen = atomic_get(&e->seq);
+	sys_slist_append(&e->subs, &sub->node);
+	k_spin_unlock(&e->lock, key);
+}
+
+void edge_publish(struct edge *e)
+{
+	struct edge_sub *sub;
+
+	e->stamp = k_cycle_get_32();
+	atomic_inc(&e->seq);
+
+	// Subscribers are only ever appended, so the list can be walked without the lock (and
+	// k_sem_give() shouldn't be called holding it).
+	SYS_SLIST_FOR_EACH_CONTAINER(&e->subs, sub, node) {
+		k_sem_give(&sub->sem);
+	}
+}
+
+int edge_wait(struct edge *e, struct edge_sub *sub, k_timeout_t timeout)
+{
+	while (1) {
+		atomic_val_t seq = atomic_get(&e->seq);
+
+		if (seq != sub->seen) {
+			int edges = seq - sub->seen;
+
+			sub->seen = seq;
+			return edges;
+		}
+		// The semaphore only says "look again": its count may be left over from an edge
+		// already seen above.
+		if (k_sem_take(&sub->sem, timeout) != 0) {
+			return -EAGAIN;
+		}
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_EDGE_H_
+#define APP_EDGE_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+
+/* Edge notification: a publisher signals transitions, and any number of subscribers wait for the
+ * next one. Unlike a k_event bit waited on with reset=true, waiting clears nothing shared: each
+ * subscriber only tracks the last sequence number it saw. Subscribers can't unsubscribe.
+ */
+struct edge {
+	atomic_t seq;
+	uint32_t stamp; /* k_cycle_get_32() of the latest edge */
+	sys_slist_t subs;
+	struct k_spinlock lock;
+};
+
+struct edge_sub {
+	sys_snode_t node;
+	struct k_sem sem;
+	atomic_val_t seen;
+};
+
+#define EDGE_DEFINE(name) struct edge name = {.subs = SYS_SLIST_STATIC_INIT(&name.subs)}
+
+/* Start tracking @e's edges from now. */
+void edge_subscribe(struct edge *e, struct edge_sub *sub);
+
+/* Signal an edge to every subscriber. Callable from ISRs. */
+void edge_publish(struct edge *e);
+
+/* Wait for an edge @sub hasn't seen yet. Returns how many edges there have been since the
+ * previous call (1 unless some were missed), or -EAGAIN on timeout. */
+int edge_wait(struct edge *e, struct edge_sub *sub, k_timeout_t timeout);
+
+/* k_cycle_get_32() when the latest edge was published. */
+static inline uint32_t edge_stamp(const struct edge *e)
+{
+	return e->stamp;
+}
+
+#endif /* APP_EDGE_H_ */
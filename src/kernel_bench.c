@@ -0,0 +1,243 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/tc_util.h>
+
+#include "bench.h"
+#include "period.h"
+#include "sched_trace.h"
+#include "threads.h"
+
+/* Stand-alone benchmark image (CONFIG_APP_BENCH_KERNEL) for the kernel primitives the application
+ * is built on. Each result is a BENCH line (see bench.h). Results over their
+ * CONFIG_APP_BENCH_MAX_* threshold add a "BENCH FAIL" line, and the run ends with
+ * "BENCH RESULT PASS" or "BENCH RESULT FAIL", which sample.yaml matches, followed by
+ * TC_END_REPORT()'s "PROJECT EXECUTION SUCCESSFUL" or "... FAILED", which twister takes as the
+ * verdict so a failing run stops there instead of waiting out its timeout.
+ *
+ * The benchmark runs in the main thread at PRIORITY_UART, against a peer thread at PRIORITY_LEDS,
+ * so cross-thread results include the same context switches as uart_out() and the blink threads.
+ */
+
+#define BENCH_EVENT BIT(0)
+#define SLEEP_MS    1
+
+struct bench_node {
+	void *fifo_reserved;
+	uint32_t led;
+	uint32_t cnt;
+};
+
+static K_FIFO_DEFINE(fifo);
+static K_EVENT_DEFINE(events);
+static K_SEM_DEFINE(ping, 0, 1);
+
+static K_THREAD_STACK_DEFINE(peer_stack, STACKSIZE);
+static struct k_thread peer;
+
+static timing_t wake_start;
+static uint32_t failures;
+
+/* @limit of 0 means no limit. */
+static void check(const char *name, uint64_t ns, uint32_t limit)
+{
+	if (limit > 0 && ns > limit) {
+		printk("BENCH FAIL %s %llu ns > %u ns\n", name, ns, limit);
+		failures++;
+	}
+}
+
+static void report(const char *name, uint32_t ops, uint64_t cycles, uint32_t limit_ns)
+{
+	bench_report(name, ops, cycles);
+	check(name, ops ? timing_cycles_to_ns(cycles) / ops : 0, limit_ns);
+}
+
+static void peer_start(k_thread_entry_t entry, uint32_t n)
+{
+	k_thread_create(&peer, peer_stack, K_THREAD_STACK_SIZEOF(peer_stack), entry,
+			(void *)(uintptr_t)n, NULL, NULL, PRIORITY_LEDS, 0, K_NO_WAIT);
+}
+
+static void bench_fifo(uint32_t n)
+{
+	struct bench_node node;
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i++) {
+		k_fifo_put(&fifo, &node);
+		(void)k_fifo_get(&fifo, K_NO_WAIT);
+	}
+	end = timing_counter_get();
+	report("k_fifo_put_get", n, timing_cycles_get(&start, &end), CONFIG_APP_BENCH_MAX_FIFO_NS);
+}
+
+static void bench_malloc(uint32_t n)
+{
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i++) {
+		k_free(k_malloc(sizeof(struct bench_node)));
+	}
+	end = timing_counter_get();
+	report("k_malloc_free", n, timing_cycles_get(&start, &end),
+	       CONFIG_APP_BENCH_MAX_MALLOC_NS);
+}
+
+static void event_setter(void *p1, void *p2, void *p3)
+{
+	uint32_t n = (uintptr_t)p1;
+
+	for (uint32_t i = 0; i < n; i++) {
+		wake_start = timing_counter_get();
+		k_event_set_masked(&events, BENCH_EVENT, BENCH_EVENT);
+	}
+}
+
+/* From k_event_set_masked() in the peer until k_event_wait() returns here, as blink_event() waits
+ * for blink(). */
+static void bench_event_wake(uint32_t n)
+{
+	uint64_t cycles = 0;
+
+	peer_start(event_setter, n);
+	for (uint32_t i = 0; i < n; i++) {
+		timing_t end;
+
+		k_event_wait(&events, BENCH_EVENT, true, K_FOREVER);
+		end = timing_counter_get();
+		cycles += timing_cycles_get(&wake_start, &end);
+	}
+	k_thread_join(&peer, K_FOREVER);
+	report("k_event_wake", n, cycles, CONFIG_APP_BENCH_MAX_EVENT_WAKE_NS);
+}
+
+static void sem_giver(void *p1, void *p2, void *p3)
+{
+	uint32_t n = (uintptr_t)p1;
+
+	for (uint32_t i = 0; i <= n; i++) {
+		k_sem_give(&ping);
+	}
+}
+
+/* Each k_sem_take() here switches to the peer, whose k_sem_give() switches straight back: one op
+ * is two context switches plus the semaphore calls. */
+static void bench_ctx_switch(uint32_t n)
+{
+	timing_t start, end;
+
+	peer_start(sem_giver, n);
+	k_sem_take(&ping, K_FOREVER);
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i++) {
+		k_sem_take(&ping, K_FOREVER);
+	}
+	end = timing_counter_get();
+	k_thread_join(&peer, K_FOREVER);
+	report("ctx_switch_round_trip", n, timing_cycles_get(&start, &end),
+	       CONFIG_APP_BENCH_MAX_CTX_SWITCH_NS);
+}
+
+/* How late k_msleep() returns. Overshoot up to a tick is expected: the sleep starts mid-tick. */
+static void bench_sleep(uint32_t n)
+{
+	uint64_t total = 0;
+	uint64_t max = 0;
+	uint64_t late_ns;
+
+	for (uint32_t i = 0; i < n; i++) {
+		timing_t start = timing_counter_get();
+		timing_t end;
+		uint64_t cycles;
+
+		k_msleep(SLEEP_MS);
+		end = timing_counter_get();
+		cycles = timing_cycles_get(&start, &end);
+		total += cycles;
+		max = MAX(max, cycles);
+	}
+	bench_report("k_msleep_1ms", n, total);
+	bench_report("k_msleep_1ms_max", 1, max);
+
+	late_ns = timing_cycles_to_ns(max) - MIN(timing_cycles_to_ns(max), SLEEP_MS * NSEC_PER_MSEC);
+	check("k_msleep_1ms_overshoot", late_ns,
+	      CONFIG_APP_BENCH_MAX_SLEEP_OVERSHOOT_US * NSEC_PER_USEC);
+}
+
+/* Runs @n periods of CONFIG_APP_BENCH_PERIOD_MS, with a loop body of a quarter period, through
+ * period_wait(). The last wakeup must stay within one period of the ideal start + n * period, and
+ * no period may be missed, however many run; with a period that isn't a whole number of ticks, a
+ * schedule that rounds the period rather than each deadline fails this. The same loop with a
+ * relative k_msleep() is shown for comparison; its drift grows with every period. */
+static void bench_period(uint32_t n)
+{
+	const uint32_t ms = CONFIG_APP_BENCH_PERIOD_MS;
+	const uint32_t body_us = ms * USEC_PER_MSEC / 4;
+	const uint32_t n_rel = MIN(n, 1000);
+	struct period p;
+	struct period_stats st;
+	int64_t start;
+	int64_t drift;
+
+	period_start(&p, ms);
+	for (uint32_t i = 0; i < n; i++) {
+		k_busy_wait(body_us);
+		period_wait(&p);
+	}
+	drift = k_uptime_ticks() - p.start - (int64_t)k_ms_to_ticks_floor64((uint64_t)n * ms);
+	period_stats_get(&p, &st);
+	printk("BENCH period_drift periods=%u missed=%u drift_ticks=%lld max_late_ticks=%lld\n",
+	       st.periods, st.missed, drift, st.max_late_ticks);
+	if (st.missed != 0 || drift < 0 || drift >= (int64_t)k_ms_to_ticks_ceil64(ms)) {
+		printk("BENCH FAIL period_drift %lld ticks and %u missed after %u periods\n", drift,
+		       st.missed, st.periods);
+		failures++;
+	}
+
+	start = k_uptime_ticks();
+	for (uint32_t i = 0; i < n_rel; i++) {
+		k_busy_wait(body_us);
+		k_msleep(ms);
+	}
+	printk("BENCH relative_sleep_drift periods=%u drift_ticks=%lld\n", n_rel,
+	       k_uptime_ticks() - start - (int64_t)k_ms_to_ticks_floor64((uint64_t)n_rel * ms));
+}
+
+int main(void)
+{
+	const uint32_t n = CONFIG_APP_BENCH_ITERATIONS;
+
+	timing_init();
+	timing_start();
+	k_thread_priority_set(k_current_get(), PRIORITY_UART);
+
+	bench_fifo(n);
+	bench_malloc(n);
+	bench_event_wake(n);
+	bench_ctx_switch(n);
+	bench_sleep(CONFIG_APP_BENCH_SLEEP_ITERATIONS);
+	bench_period(CONFIG_APP_BENCH_PERIODS);
+#ifdef CONFIG_APP_BENCH_SCHED
+	sched_bench(n);
+#endif
+#ifdef CONFIG_APP_BENCH_ZBUS
+	zbus_bench(n);
+#endif
+	// With CONFIG_APP_SCHED_TRACE, the last CONFIG_APP_SCHED_TRACE_RECORDS events of the run.
+	sched_trace_dump();
+
+	if (failures > 0) {
+		printk("BENCH RESULT FAIL %u over threshold\n", failures);
+	} else {
+		printk("BENCH RESULT PASS\n");
+	}
+	// On native_sim this also exits the process.
+	TC_END_REPORT(failures > 0 ? TC_FAIL : TC_PASS);
+	return 0;
+}
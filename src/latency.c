@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "latency.h"
+
+static struct latency_histogram hist[LATENCY_STAGES][CONFIG_APP_TELEMETRY_MAX_LEDS];
+static struct k_spinlock lock;
+
+static uint32_t bucket_of(uint32_t us)
+{
+	uint32_t octave;
+	uint32_t idx;
+
+	if (us < 2) {
+		return us;
+	}
+	octave = 31 - __builtin_clz(us);
+	idx = 2 * octave + ((us >> (octave - 1)) & 1);
+	return MIN(idx, LATENCY_BUCKETS - 1);
+}
+
+static uint32_t bucket_upper_us(uint32_t idx)
+{
+	uint32_t octave = idx / 2;
+
+	if (idx < 2) {
+		return idx;
+	}
+	return ((2 + idx % 2) << (octave - 1)) + (1 << (octave - 1)) - 1;
+}
+
+void latency_bucket_bounds(uint32_t idx, uint32_t *lo_us, uint32_t *hi_us)
+{
+	*lo_us = idx < 2 ? idx : bucket_upper_us(idx - 1) + 1;
+	*hi_us = idx < LATENCY_BUCKETS - 1 ? bucket_upper_us(idx) : UINT32_MAX;
+}
+
+void latency_histogram_add(struct latency_histogram *h, uint32_t us)
+{
+	h->count++;
+	h->buckets[bucket_of(us)]++;
+	h->max_us = MAX(h->max_us, us);
+}
+
+void latency_record(enum latency_stage stage, uint32_t led, uint32_t stamp)
+{
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - stamp);
+	k_spinlock_key_t key;
+
+	if (stage >= LATENCY_STAGES || led >= CONFIG_APP_TELEMETRY_MAX_LEDS) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	latency_histogram_add(&hist[stage][led], us);
+	k_spin_unlock(&lock, key);
+}
+
+static uint32_t percentile(const struct latency_histogram *h, uint32_t pct)
+{
+	uint32_t target = DIV_ROUND_UP((uint64_t)h->count * pct, 100);
+	uint32_t seen = 0;
+
+	for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+		seen += h->buckets[i];
+		if (seen >= target && seen > 0) {
+			return MIN(bucket_upper_us(i), h->max_us);
+		}
+	}
+	return h->max_us;
+}
+
+void latency_histogram_summarize(const struct latency_histogram *h,
+				 struct latency_summary *summary)
+{
+	summary->count = h->count;
+	summary->p50_us = percentile(h, 50);
+	summary->p99_us = percentile(h, 99);
+	summary->max_us = h->max_us;
+}
+
+int latency_summary_get(enum latency_stage stage, uint32_t led, struct latency_summary *summary)
+{
+	struct latency_histogram snapshot;
+	k_spinlock_key_t key;
+
+	if (stage >= LATENCY_STAGES || led >= CONFIG_APP_TELEMETRY_MAX_LEDS) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	snapshot = hist[stage][led];
+	k_spin_unlock(&lock, key);
+
+	latency_histogram_summarize(&snapshot, summary);
+	return 0;
+}
+
+const char *latency_stage_name(enum latency_stage stage)
+{
+	switch (stage) {
+	case LATENCY_DEQUEUE:
+		return "dequeue";
+	case LATENCY_TX_DONE:
+		return "tx_done";
+	default:
+		return "?";
+	}
+}
+
+void latency_dump(void)
+{
+	struct latency_summary s;
+
+	for (uint32_t led = 0; led < CONFIG_APP_TELEMETRY_MAX_LEDS; led++) {
+		for (enum latency_stage stage = 0; stage < LATENCY_STAGES; stage++) {
+			latency_summary_get(stage, led, &s);
+			printk("latency led%u %s: n=%u p50=%uus p99=%uus max=%uus\n", led,
+			       latency_stage_name(stage), s.count, s.p50_us, s.p99_us, s.max_us);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_LATENCY_H_
+#define APP_LATENCY_H_
+
+#include <stdint.h>
+
+/* Toggle-to-UART latency, measured from the k_cycle_get_32() stamp a blink thread takes when it
+ * sets the LED. */
+enum latency_stage {
+	LATENCY_DEQUEUE, /* uart_out() took the record off the telemetry queue */
+	LATENCY_TX_DONE, /* the UART finished sending the record */
+	LATENCY_STAGES,
+};
+
+struct latency_summary {
+	uint32_t count;
+	uint32_t p50_us; /* percentiles are bucket upper bounds, within ~40% of the true value */
+	uint32_t p99_us;
+	uint32_t max_us; /* exact */
+};
+
+/* Half-octave buckets in microseconds: values 0 and 1 get their own bucket, then each power of two
+ * is split in two. 48 buckets reach ~16 s; anything longer lands in the last one. The per-LED
+ * stages keep one per LED and stage; other measurements (see button.h) can keep their own. */
+#define LATENCY_BUCKETS 48
+
+struct latency_histogram {
+	uint32_t count;
+	uint32_t max_us;
+	uint32_t buckets[LATENCY_BUCKETS];
+};
+
+/* Histogram helpers. None of them lock; the owner of @h serialises access. */
+void latency_histogram_add(struct latency_histogram *h, uint32_t us);
+void latency_histogram_summarize(const struct latency_histogram *h,
+				 struct latency_summary *summary);
+
+/* Smallest and largest value in microseconds that bucket @idx holds. */
+void latency_bucket_bounds(uint32_t idx, uint32_t *lo_us, uint32_t *hi_us);
+
+/* Add one sample. Safe from any context, including the UART ISR. */
+void latency_record(enum latency_stage stage, uint32_t led, uint32_t stamp);
+
+/* Returns 0, or -EINVAL if @led or @stage has no histogram. */
+int latency_summary_get(enum latency_stage stage, uint32_t led, struct latency_summary *summary);
+
+/* printk() p50/p99/max for every LED and stage. */
+void latency_dump(void);
+
+const char *latency_stage_name(enum latency_stage stage);
+
+#endif /* APP_LATENCY_H_ */
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "led_frame.h"
+
+int led_frame_set(struct led_frame *frame, const struct gpio_dt_spec *spec, bool on)
+{
+	gpio_port_pins_t pin = BIT(spec->pin);
+	bool raw = on ^ ((spec->dt_flags & GPIO_ACTIVE_LOW) != 0);
+	size_t i;
+
+	for (i = 0; i < frame->nports; i++) {
+		if (frame->ports[i].port == spec->port) {
+			break;
+		}
+	}
+	if (i == frame->nports) {
+		if (i == ARRAY_SIZE(frame->ports)) {
+			return -ENOSPC;
+		}
+		frame->ports[i].port = spec->port;
+		frame->ports[i].mask = 0;
+		frame->ports[i].value = 0;
+		frame->nports++;
+	}
+
+	frame->ports[i].mask |= pin;
+	frame->ports[i].value = raw ? (frame->ports[i].value | pin) : (frame->ports[i].value & ~pin);
+	return 0;
+}
+
+int led_frame_commit(struct led_frame *frame)
+{
+	int ret = 0;
+
+	for (size_t i = 0; i < frame->nports; i++) {
+		int err = gpio_port_set_masked_raw(frame->ports[i].port, frame->ports[i].mask,
+						   frame->ports[i].value);
+
+		if (err != 0 && ret == 0) {
+			ret = err;
+		}
+	}
+	frame->nports = 0;
+	return ret;
+}
@@ -0,0 +1,39 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_LED_FRAME_H_
+#define APP_LED_FRAME_H_
+
+#include <stdbool.h>
+#include <zephyr/drivers/gpio.h>
+
+/* Distinct GPIO ports one frame can touch. */
+#define LED_FRAME_MAX_PORTS 4
+
+/* A batch of LED updates. Stage the new states with led_frame_set(), then led_frame_commit()
+ * writes each GPIO port once with gpio_port_set_masked_raw(), so LEDs on the same port change in
+ * the same register write. Active-low pins are inverted while staging.
+ */
+struct led_frame {
+	struct {
+		const struct device *port;
+		gpio_port_pins_t mask;
+		gpio_port_value_t value;
+	} ports[LED_FRAME_MAX_PORTS];
+	size_t nports;
+};
+
+static inline void led_frame_init(struct led_frame *frame)
+{
+	frame->nports = 0;
+}
+
+/* Stage @spec at logical level @on. Returns 0, or -ENOSPC if the frame already holds
+ * LED_FRAME_MAX_PORTS other ports. */
+int led_frame_set(struct led_frame *frame, const struct gpio_dt_spec *spec, bool on);
+
+/* Write every staged port and empty the frame. Returns 0 or the first driver error. */
+int led_frame_commit(struct led_frame *frame);
+
+#endif /* APP_LED_FRAME_H_ */
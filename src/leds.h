@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_LEDS_H_
+#define APP_LEDS_H_
+
+#include <stdint.h>
+
+#include "period.h"
+
+/* Times the LED engine (CONFIG_APP_LED_ENGINE) has woken up to blink since boot: blink thread
+ * sleeps and waits returning, timer expiries, scheduler wakeups or stackless tasks resuming. */
+uint32_t led_wakeups_get(void);
+
+/* Toggles the LED engines have made since boot, not counting the busy loops. Against
+ * led_wakeups_get(), shows how many steps share a wakeup. */
+uint32_t led_steps_get(void);
+
+/* Deadline statistics of blink() for @led (thread and workqueue engines only): periods, missed
+ * periods and drift. Returns 0, or -EINVAL if there is no such LED. */
+int led_period_stats_get(uint32_t led, struct period_stats *stats);
+
+struct led_work_stats {
+	uint32_t depth;          /* jobs queued behind the last one to run, when it started */
+	uint32_t max_depth;      /* worst depth so far */
+	uint32_t max_runtime_us; /* longest a job's handler has run */
+};
+
+/* Workqueue engine statistics. Returns 0, or -ENOTSUP with any other engine. */
+int led_work_stats_get(struct led_work_stats *stats);
+
+struct led_activity {
+	uint32_t toggles;
+	uint32_t max_gap_ms; /* longest between two toggles, or since the last one; not tracked for
+			      * the busy loops, which only count toggles */
+};
+
+/* How often @led has toggled and how long it has gone without. Returns 0, or -EINVAL if there is
+ * no such LED. */
+int led_activity_get(uint32_t led, struct led_activity *act);
+
+/* Toggle @led from outside the LED engines, e.g. as feedback for a button press. Its engine keeps
+ * driving it as before. Returns 0, -EINVAL if there is no such LED, -ENODEV if init() couldn't
+ * configure it (or hasn't yet), or the GPIO driver's error. */
+int led_toggle(uint32_t led);
+
+struct led1_wake_stats {
+	const char *path; /* CONFIG_APP_LED1_NOTIFY: "edge" or "events" */
+	uint32_t count;
+	uint32_t avg_us;
+	uint32_t max_us;
+};
+
+/* How long blink_event() took to wake after LED1 turned on (thread engine only). */
+void led1_wake_stats_get(struct led1_wake_stats *stats);
+
+/* Set up @evt to poll for LED1 changing state, signalled once the change's telemetry record is
+ * queued. The poller resets evt->signal after each wakeup. */
+void led1_poll_init(struct k_poll_event *evt);
+
+/* CONFIG_APP_SCENARIO running on LED3, e.g. "low_noyield", or "none". */
+const char *led_scenario_name(void);
+
+/* The same, as sent in TELEMETRY_MSG_SCENARIO_RATE; scripts/telemetry_decode.py's SCENARIOS
+ * lists the names in this order. */
+enum led_scenario {
+	LED_SCENARIO_NONE,
+	LED_SCENARIO_HIGH_BUSY,
+	LED_SCENARIO_EQUAL_YIELD,
+	LED_SCENARIO_LOW_YIELD,
+	LED_SCENARIO_EQUAL_NOYIELD,
+	LED_SCENARIO_LOW_NOYIELD,
+};
+
+enum led_scenario led_scenario_id(void);
+
+#endif /* APP_LEDS_H_ */
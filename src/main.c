@@ -7,143 +7,417 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/printk.h>
 #include <zephyr/sys/__assert.h>
 #include <string.h>
 
-/* size of stack area used by each thread */
-#define STACKSIZE 1024
-
-/* scheduling priority used by each thread */
-#define PRIORITY_LEDS 7
-#define PRIORITY_UART 1
-#define PRIORITY_INIT 0
+#include "boot_phase.h"
+#include "coro.h"
+#include "edge.h"
+#include "led_frame.h"
+#include "leds.h"
+#include "period.h"
+#include "sched_trace.h"
+#include "telemetry.h"
+#include "threads.h"
+#include "uart_out.h"
 
 /* Events */
 #define EVENT_INIT_DONE 1
 #define EVENT_LED1_ON   2
 
-#define LED0_NODE DT_ALIAS(led0)
-#define LED1_NODE DT_ALIAS(led1)
-#define LED2_NODE DT_ALIAS(led2)
-#define LED3_NODE DT_ALIAS(led3)
-
-#if !DT_NODE_HAS_STATUS(LED0_NODE, okay)
-#error "Unsupported board: led0 devicetree alias is not defined"
-#endif
-
-#if !DT_NODE_HAS_STATUS(LED1_NODE, okay)
-#error "Unsupported board: led1 devicetree alias is not defined"
-#endif
-
-#if !DT_NODE_HAS_STATUS(LED2_NODE, okay)
-#error "Unsupported board: led2 devicetree alias is not defined"
-#endif
+/* Every child of the board's gpio-leds node, in devicetree order. */
+#define LEDS_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(gpio_leds)
 
-#if !DT_NODE_HAS_STATUS(LED3_NODE, okay)
-#error "Unsupported board: led3 devicetree alias is not defined"
+#if !DT_NODE_EXISTS(LEDS_NODE)
+#error "Unsupported board: no gpio-leds devicetree node"
 #endif
 
-struct printk_data_t {
-	void *fifo_reserved; /* 1st word reserved for use by fifo */
-	uint32_t led;
-	uint32_t cnt;
-};
-
-K_FIFO_DEFINE(printk_fifo);
 K_EVENT_DEFINE(events)
 
 struct led {
 	struct gpio_dt_spec spec;
-	uint8_t num;
 };
 
-static const struct led led0 = {
-	.spec = GPIO_DT_SPEC_GET_OR(LED0_NODE, gpios, {0}),
-	.num = 0,
-};
+#define LED_ENTRY(node_id)                                                                         \
+	{                                                                                          \
+		.spec = GPIO_DT_SPEC_GET(node_id, gpios),                                          \
+	},
+
+/* Disabled children (often switched off by a board overlay) are left out, so an LED's number is
+ * its index here: the position among the enabled children. */
+static const struct led leds[] = {DT_FOREACH_CHILD_STATUS_OKAY(LEDS_NODE, LED_ENTRY)};
+
+BUILD_ASSERT(ARRAY_SIZE(leds) >= 4, "Unsupported board: the demo needs at least four LEDs");
+BUILD_ASSERT(ARRAY_SIZE(leds) <= CONFIG_APP_TELEMETRY_MAX_LEDS,
+	     "Raise CONFIG_APP_TELEMETRY_MAX_LEDS to the board's number of LEDs");
+
+/* The LED number used in telemetry and the per-LED statistics. */
+static inline uint32_t led_num(const struct led *led)
+{
+	return led - leds;
+}
+
+/* LEDs init() configured successfully, by index in leds[]. The others are never touched. */
+static ATOMIC_DEFINE(leds_ready, ARRAY_SIZE(leds));
+
+static bool led_is_ready(const struct led *led)
+{
+	return atomic_test_bit(leds_ready, led - leds);
+}
 
-static const struct led led1 = {
-	.spec = GPIO_DT_SPEC_GET_OR(LED1_NODE, gpios, {0}),
-	.num = 1,
+/* What the LED engines do with each LED. The first four play the demo's roles (the same as the
+ * blink threads at the bottom of this file); any others blink at CONFIG_APP_LED_EXTRA_PERIOD_MS.
+ */
+enum led_mode {
+	LED_MODE_OFF,
+	LED_MODE_BLINK,       /* blink() */
+	LED_MODE_FOLLOW_LED1, /* blink_event() */
+	LED_MODE_BUSY,        /* blink_noyield(), a thread except with the stackless engine */
 };
 
-static const struct led led2 = {
-	.spec = GPIO_DT_SPEC_GET_OR(LED2_NODE, gpios, {0}),
-	.num = 2,
+struct led_role {
+	enum led_mode mode;
+	uint32_t period_ms;
+	uint32_t delay_ms; /* start delay from boot, as in K_THREAD_DEFINE */
 };
 
-static const struct led led3 = {
-	.spec = GPIO_DT_SPEC_GET_OR(LED3_NODE, gpios, {0}),
-	.num = 3,
+static const struct led_role demo_roles[] = {
+	{LED_MODE_BLINK, 100, 0},
+	{LED_MODE_BLINK, 1000, 5000},
+	{LED_MODE_FOLLOW_LED1, 200, 0},
+	{LED_MODE_BUSY, 1000, 0},
 };
 
+static struct led_role __unused led_role(size_t i)
+{
+	if (i < ARRAY_SIZE(demo_roles)) {
+		return demo_roles[i];
+	}
+	return (struct led_role){
+		.mode = CONFIG_APP_LED_EXTRA_PERIOD_MS > 0 ? LED_MODE_BLINK : LED_MODE_OFF,
+		.period_ms = CONFIG_APP_LED_EXTRA_PERIOD_MS,
+	};
+}
+
+/* Times an LED engine woke up to blink: a blink thread returning from a sleep or wait, a timer
+ * expiry, a scheduler wakeup, or a stackless task resuming from a sleep or wait. */
+static atomic_t led_wakeups;
+
+static inline void led_wakeups_count(void)
+{
+	atomic_inc(&led_wakeups);
+}
+
+uint32_t led_wakeups_get(void)
+{
+	return atomic_get(&led_wakeups);
+}
+
+/* Toggles made by the LED engines, busy loops aside: what the wakeups above are for. */
+static atomic_t led_steps;
+
+uint32_t led_steps_get(void)
+{
+	return atomic_get(&led_steps);
+}
+
+/* Toggles and the longest gap between two, by index in leds[], to measure the scheduling
+ * scenarios. Each entry is only written by whatever drives that LED. */
+static struct {
+	atomic_t toggles;
+	volatile uint32_t spins; /* toggles of the busy loops, which only store their count */
+	uint32_t last_ms;
+	uint32_t max_gap_ms;
+} activity[ARRAY_SIZE(leds)];
+
+static void led_toggled(const struct led *led)
+{
+	size_t i = led - leds;
+	uint32_t now = k_uptime_get_32();
+
+	atomic_inc(&led_steps);
+	if (atomic_inc(&activity[i].toggles) > 0) {
+		activity[i].max_gap_ms = MAX(activity[i].max_gap_ms, now - activity[i].last_ms);
+	}
+	activity[i].last_ms = now;
+}
+
+int led_toggle(uint32_t led)
+{
+	if (led >= ARRAY_SIZE(leds)) {
+		return -EINVAL;
+	}
+	if (!led_is_ready(&leds[led])) {
+		return -ENODEV;
+	}
+	return gpio_pin_toggle_dt(&leds[led].spec);
+}
+
+int led_activity_get(uint32_t led, struct led_activity *act)
+{
+	uint32_t now = k_uptime_get_32();
+
+	if (led >= ARRAY_SIZE(activity)) {
+		return -EINVAL;
+	}
+	act->toggles = atomic_get(&activity[led].toggles) + activity[led].spins;
+	// An LED that is being starved right now (or has been since boot) counts too.
+	act->max_gap_ms =
+		MAX(activity[led].max_gap_ms, now - (act->toggles ? activity[led].last_ms : 0));
+	return 0;
+}
+
+/* LED1 rising edges, from blink() to blink_event(). CONFIG_APP_LED1_NOTIFY picks between an edge
+ * notification and the original k_event_wait(&events, EVENT_LED1_ON, true, ...), which clears
+ * every other event bit too. Either way the wakeup latency is measured. */
+#ifdef CONFIG_APP_LED1_NOTIFY_EDGE
+static EDGE_DEFINE(led1_rise);
+#else
+static uint32_t led1_on_stamp;
+#endif
+
+/* Raised on every LED1 change, once its record is queued, for uart_out(): k_poll() can't wait on
+ * the k_event. The result is LED1's new state. */
+static struct k_poll_signal led1_changed = K_POLL_SIGNAL_INITIALIZER(led1_changed);
+
+void led1_poll_init(struct k_poll_event *evt)
+{
+	k_poll_event_init(evt, K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &led1_changed);
+}
+
+/* Tell everything that follows LED1 about its new state: the event bit (set _masked so
+ * EVENT_INIT_DONE remains set), blink_event()'s rising edge and uart_out(). Callable from ISRs. */
+static void led1_state_publish(bool on)
+{
+#ifndef CONFIG_APP_LED1_NOTIFY_EDGE
+	// Only rising edges wake blink_event(); an off edge would overwrite the stamp it reads.
+	if (on) {
+		led1_on_stamp = k_cycle_get_32();
+	}
+#endif
+	sched_trace_record(SCHED_TRACE_EVENT_SET, on ? EVENT_LED1_ON : 0);
+	k_event_set_masked(&events, on ? EVENT_LED1_ON : 0, EVENT_LED1_ON);
+#ifdef CONFIG_APP_LED1_NOTIFY_EDGE
+	if (on) {
+		edge_publish(&led1_rise);
+	}
+#endif
+	k_poll_signal_raise(&led1_changed, on);
+}
+
+#ifdef CONFIG_APP_TELEMETRY_ZBUS
+/* The counter of the last LED1 record the listener below passed on. */
+static atomic_t led1_listened = ATOMIC_INIT(-1);
+
+/* With zbus, LED1's state reaches its followers from the led_state channel rather than from
+ * whichever engine toggled it: this listener runs in the publisher's context and reads each record
+ * in place, so it costs no copy and no queueing. */
+static void led1_listener_cb(const struct zbus_channel *chan)
+{
+	const struct telemetry_record *rec = zbus_chan_const_msg(chan);
+
+	if (rec->led == led_num(&leds[1])) {
+		led1_state_publish(rec->cnt % 2);
+		atomic_set(&led1_listened, rec->cnt);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(led1_listener, led1_listener_cb);
+ZBUS_CHAN_ADD_OBS(led_state_chan, led1_listener, 0);
+#endif
+
+/* Called once LED1's record with counter @cnt has been published, or dropped. */
+static void led1_published(uint32_t cnt)
+{
+#ifdef CONFIG_APP_TELEMETRY_ZBUS
+	// The listener has passed the state on, unless the publish failed before reaching it (the
+	// channel busy for an ISR, or no message buffers). Losing telemetry mustn't lose LED1's
+	// followers a transition.
+	if ((uint32_t)atomic_get(&led1_listened) == cnt) {
+		return;
+	}
+#endif
+	led1_state_publish(cnt % 2);
+}
+
+static struct k_spinlock led1_wake_lock;
+static struct {
+	uint32_t count;
+	uint64_t sum;
+	uint32_t max;
+} led1_wake; /* cycles from LED1 turning on to blink_event() waking */
+
+static void led1_wake_record(uint32_t stamp)
+{
+	uint32_t cycles = k_cycle_get_32() - stamp;
+	k_spinlock_key_t key = k_spin_lock(&led1_wake_lock);
+
+	led1_wake.count++;
+	led1_wake.sum += cycles;
+	led1_wake.max = MAX(led1_wake.max, cycles);
+	k_spin_unlock(&led1_wake_lock, key);
+}
+
+void led1_wake_stats_get(struct led1_wake_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&led1_wake_lock);
+
+	stats->count = led1_wake.count;
+	stats->avg_us = led1_wake.count ? k_cyc_to_us_floor32(led1_wake.sum / led1_wake.count) : 0;
+	stats->max_us = k_cyc_to_us_floor32(led1_wake.max);
+	k_spin_unlock(&led1_wake_lock, key);
+	stats->path = IS_ENABLED(CONFIG_APP_LED1_NOTIFY_EDGE) ? "edge" : "events";
+}
+
+/* blink()'s deadlines, by LED number. */
+static struct period blink_periods[ARRAY_SIZE(leds)];
+
+int led_period_stats_get(uint32_t led, struct period_stats *stats)
+{
+	if (led >= ARRAY_SIZE(blink_periods)) {
+		return -EINVAL;
+	}
+	period_stats_get(&blink_periods[led], stats);
+	return 0;
+}
+
+#if defined(CONFIG_APP_LED_ENGINE_TIMER)
+static void led_timers_start(void);
+#elif defined(CONFIG_APP_LED_ENGINE_WORKQUEUE)
+static void led_works_start(void);
+#endif
+
+/* Light the LEDs one by one, then turn them off in reverse order. */
+static void boot_animation(void)
+{
+	for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
+		if (led_is_ready(&leds[i])) {
+			gpio_pin_set(leds[i].spec.port, leds[i].spec.pin, true);
+		}
+		k_msleep(200);
+	}
+	k_msleep(500);
+
+	for (int8_t i = ARRAY_SIZE(leds) - 1; i >= 0; i--) {
+		if (led_is_ready(&leds[i])) {
+			gpio_pin_set(leds[i].spec.port, leds[i].spec.pin, false);
+		}
+		k_msleep(200);
+	}
+	k_msleep(500);
+}
+
 void init()
 {
-	struct led leds[] = {led0, led1, led2, led3};
-	for (uint8_t i = 0; i < 4; i++) {
+	boot_phase_mark(BOOT_PHASE_MAIN);
+
+	// A LED that can't be configured is left out rather than holding every other task back.
+	for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
 		const struct gpio_dt_spec *spec = &(leds[i].spec);
 		if (!device_is_ready(spec->port)) {
 			printk("Error: %s device is not ready\n", spec->port->name);
-			return;
+			continue;
 		}
-		uint8_t ret = gpio_pin_configure_dt(spec, GPIO_OUTPUT);
+		int ret = gpio_pin_configure_dt(spec, GPIO_OUTPUT);
 		if (ret != 0) {
 			printk("Error %d: failed to configure pin %d (LED '%d')\n", ret, spec->pin,
-			       leds[i].num);
-			return;
+			       i);
+			continue;
 		}
-		gpio_pin_set(spec->port, spec->pin, true);
-		k_msleep(200);
+		atomic_set_bit(leds_ready, i);
 	}
-	k_msleep(500);
+	boot_phase_mark(BOOT_PHASE_CONFIGURED);
 
-	for (int8_t i = 3; i >= 0; i--) {
-		gpio_pin_set(leds[i].spec.port, leds[i].spec.pin, false);
-		k_msleep(200);
-	}
-	k_msleep(500);
+#ifdef CONFIG_APP_BOOT_ANIMATION_BLOCKING
+	boot_animation();
+#endif
+
+#ifdef CONFIG_APP_BENCH_TELEMETRY_POOL
+	telemetry_pool_bench();
+#endif
+#ifdef CONFIG_APP_BENCH_TELEMETRY_RING
+	telemetry_ring_bench();
+#endif
+#ifdef CONFIG_APP_BENCH_CORO
+	coro_bench();
+#endif
 
-	// All tasks will wait until the INIT_DONE event is set. `gpio_pin_set`
-	// above demonstrates that `init` has exclusive control until freeing the other tasks.
+	// All tasks will wait until the INIT_DONE event is set. With the blocking boot animation,
+	// `gpio_pin_set` above demonstrates that `init` has exclusive control until freeing the
+	// other tasks.
+	sched_trace_record(SCHED_TRACE_EVENT_SET, EVENT_INIT_DONE);
 	k_event_set(&events, EVENT_INIT_DONE);
+
+#if defined(CONFIG_APP_LED_ENGINE_TIMER)
+	led_timers_start();
+#elif defined(CONFIG_APP_LED_ENGINE_WORKQUEUE)
+	led_works_start();
+#endif
+
+#ifdef CONFIG_APP_BOOT_ANIMATION_ASYNC
+	// The other tasks are running now; the animation only delays this (otherwise idle) thread.
+	boot_animation();
+#endif
 }
 /* This version of blink() never invokes the kernel, so never has yield points. */
 void blink_noyield(const struct led *led, uint32_t sleep_ms, uint32_t id)
 {
-	int cnt = 0;
+	volatile uint32_t *spins = &activity[led - leds].spins;
+	uint32_t cnt = 0;
 
 	k_event_wait(&events, EVENT_INIT_DONE, false, K_FOREVER);
+	if (!led_is_ready(led)) {
+		return;
+	}
+	boot_phase_mark(BOOT_PHASE_FIRST_TOGGLE);
 
 	while (1) {
 		gpio_pin_set(led->spec.port, led->spec.pin, cnt % 2);
-		cnt++;
+		// The busy-loop probe's counter (src/busy_probe.h): one plain store per iteration, no
+		// clock read or atomic read-modify-write to slow the loop down.
+		*spins = ++cnt;
+#ifdef CONFIG_ARCH_POSIX
+		// native_sim's simulated time only passes while the CPU idles or busy-waits, so a
+		// loop that never does either would stop the clock and every interrupt with it.
+		k_busy_wait(1);
+#endif
 	}
 }
 
 /* This version of blink() uses kernel sleeps to allow other tasks to perform work. */
 void blink(const struct led *led, uint32_t sleep_ms, uint32_t id)
 {
+	struct period *period = &blink_periods[led_num(led)];
 	int cnt = 0;
 
 	k_event_wait(&events, EVENT_INIT_DONE, false, K_FOREVER);
+	if (!led_is_ready(led)) {
+		return;
+	}
+	period_start(period, sleep_ms);
 
 	while (1) {
-		// Publish the state of LED1 as an event. Using _masked ensures that EVENT_INIT_DONE remains set.
-		if (led->num == led1.num) {
-			k_event_set_masked(&events, (cnt % 2) ? EVENT_LED1_ON : 0, EVENT_LED1_ON);
-		}
-
 		gpio_pin_set(led->spec.port, led->spec.pin, cnt % 2);
+		led_toggled(led);
+		boot_phase_mark(BOOT_PHASE_FIRST_TOGGLE);
 
-		struct printk_data_t *tx_data =
-			(struct printk_data_t *)k_malloc(sizeof(struct printk_data_t));
-		__ASSERT_NO_MSG(mem_ptr != 0);
-		tx_data->led = id;
-		tx_data->cnt = cnt;
-		k_fifo_put(&printk_fifo, tx_data);
+		telemetry_publish(id, cnt, k_cycle_get_32());
+		// Publish the state of LED1 to the threads that follow it.
+		if (led == &leds[1]) {
+			led1_published(cnt);
+		}
 
-		k_msleep(sleep_ms);
+		// Sleep until the next deadline rather than for sleep_ms, so the time spent above (or
+		// preempted) doesn't stretch the period and the LEDs don't drift apart. A sleep_ms of 0
+		// busy-loops, yielding only to threads of the same or higher priority.
+		if (sleep_ms == 0) {
+			k_yield();
+		} else {
+			period_wait(period);
+			led_wakeups_count();
+		}
 		cnt++;
 	}
 }
@@ -152,9 +426,19 @@ void blink(const struct led *led, uint32_t sleep_ms, uint32_t id)
 void blink_event(const struct led *led, uint32_t sleep_ms, uint32_t id)
 {
 	int cnt = 0;
+#ifdef CONFIG_APP_LED1_NOTIFY_EDGE
+	struct edge_sub led1_sub;
+#endif
 
 	k_event_wait(&events, EVENT_INIT_DONE, false, K_FOREVER);
+	if (!led_is_ready(led)) {
+		return;
+	}
 	k_event_wait(&events, EVENT_LED1_ON, false, K_FOREVER);
+#ifdef CONFIG_APP_LED1_NOTIFY_EDGE
+	// Subscribed once LED1 is on, so the first edge_wait() is for the next rising edge.
+	edge_subscribe(&led1_rise, &led1_sub);
+#endif
 
 	while (1) {
 		// If reset=false, LED2 will blink as long as LED1 is on.
@@ -164,83 +448,587 @@ void blink_event(const struct led *led, uint32_t sleep_ms, uint32_t id)
 		// to represent a transient state or a barrier to unblock a bunch of tasks
 		// in a synchronized way. 
 		// k_event_wait(&events, EVENT_LED1_ON, false, K_FOREVER);
+		// An edge notification blinks once per rising edge like reset=true, but clears nothing
+		// shared, so any number of threads can follow LED1.
 		if (cnt % 2) {
+#ifdef CONFIG_APP_LED1_NOTIFY_EDGE
+			edge_wait(&led1_rise, &led1_sub, K_FOREVER);
+			led1_wake_record(edge_stamp(&led1_rise));
+#else
+			sched_trace_record(SCHED_TRACE_EVENT_WAIT, EVENT_LED1_ON);
 			k_event_wait(&events, EVENT_LED1_ON, true, K_FOREVER);
+			sched_trace_record(SCHED_TRACE_EVENT_WOKE, EVENT_LED1_ON);
+			led1_wake_record(led1_on_stamp);
+#endif
+			led_wakeups_count();
 		}
 
 		gpio_pin_set(led->spec.port, led->spec.pin, cnt % 2);
+		led_toggled(led);
+		boot_phase_mark(BOOT_PHASE_FIRST_TOGGLE);
 
-		struct printk_data_t *tx_data =
-			(struct printk_data_t *)k_malloc(sizeof(struct printk_data_t));
-		__ASSERT_NO_MSG(mem_ptr != 0);
-		tx_data->led = id;
-		tx_data->cnt = cnt;
-		k_fifo_put(&printk_fifo, tx_data);
+		telemetry_publish(id, cnt, k_cycle_get_32());
 
 		k_msleep(sleep_ms);
+		led_wakeups_count();
 		cnt++;
 	}
 }
 
+#if defined(CONFIG_APP_LED_ENGINE_TIMER) || defined(CONFIG_APP_LED_ENGINE_SCHEDULER) ||         \
+	defined(CONFIG_APP_LED_ENGINE_WORKQUEUE)
+
+/* The timer, scheduler and workqueue engines run blink() and blink_event() one iteration (a
+ * "step") at a time, without a thread per LED. */
+struct led_job {
+	const struct led *led;
+	uint32_t sleep_ms;
+	uint32_t delay_ms; /* start delay from boot, as in K_THREAD_DEFINE */
+	uint32_t id;
+	uint32_t cnt;
+	bool follows_led1; /* blink_event(): odd steps wait for LED1 to turn on */
+	bool triggered;
+	atomic_t waiting;
+#if defined(CONFIG_APP_LED_ENGINE_TIMER)
+	struct k_timer timer;
+#elif defined(CONFIG_APP_LED_ENGINE_WORKQUEUE)
+	struct k_work_delayable work;
+#else
+	int64_t due; /* uptime (ms) of the next step */
+#endif
+};
+
+/* One constant-size entry per LED the engine drives, filled in by led_jobs_init(). */
+static struct led_job led_jobs[ARRAY_SIZE(leds)];
+static size_t led_jobs_len;
+
+static void led_jobs_init(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(leds); i++) {
+		struct led_role role = led_role(i);
+		struct led_job *job;
+
+		if ((role.mode != LED_MODE_BLINK && role.mode != LED_MODE_FOLLOW_LED1) ||
+		    !led_is_ready(&leds[i])) {
+			continue;
+		}
+		job = &led_jobs[led_jobs_len++];
+		job->led = &leds[i];
+		job->sleep_ms = role.period_ms;
+		job->delay_ms = role.delay_ms;
+		job->id = i;
+		job->follows_led1 = role.mode == LED_MODE_FOLLOW_LED1;
+		atomic_set(&job->waiting, job->follows_led1);
+	}
+}
+
+static void led_job_resume(struct led_job *job);
+
+/* Where blink_event() would return from k_event_wait(&events, EVENT_LED1_ON, ...). */
+static void led1_turned_on(void)
+{
+	for (size_t i = 0; i < led_jobs_len; i++) {
+		struct led_job *job = &led_jobs[i];
+
+		if (job->follows_led1 && atomic_cas(&job->waiting, 1, 0)) {
+			job->triggered = true;
+			led_job_resume(job);
+		}
+	}
+}
+
+/* Stages the LED's new state in @frame for the caller to commit, committing it early if it is
+ * full. Returns false, without doing anything, if the job must first wait for LED1 to turn on. */
+static bool led_job_step(struct led_job *job, struct led_frame *frame)
+{
+	bool on = job->cnt % 2;
+
+	if (job->follows_led1 && on && !job->triggered) {
+		atomic_set(&job->waiting, 1);
+		return false;
+	}
+	job->triggered = false;
+
+	// With LEDs on more ports than a frame holds, write what is staged so far and start a new
+	// frame; an empty frame always has room.
+	if (led_frame_set(frame, &job->led->spec, on) == -ENOSPC) {
+		led_frame_commit(frame);
+		(void)led_frame_set(frame, &job->led->spec, on);
+	}
+	led_toggled(job->led);
+	boot_phase_mark(BOOT_PHASE_FIRST_TOGGLE);
+
+	telemetry_publish(job->id, job->cnt, k_cycle_get_32());
+
+	if (job->led == &leds[1]) {
+		led1_published(job->cnt);
+		if (on) {
+			led1_turned_on();
+		}
+	}
+	job->cnt++;
+	return true;
+}
+
+#endif /* CONFIG_APP_LED_ENGINE_TIMER || _SCHEDULER || _WORKQUEUE */
+
+#if defined(CONFIG_APP_LED_ENGINE_TIMER)
+
+/* Timer engine: each job has a k_timer whose expiry function runs its steps in the system clock
+ * ISR. */
+static void led_timer_expiry(struct k_timer *timer)
+{
+	struct led_job *job = CONTAINER_OF(timer, struct led_job, timer);
+	struct led_frame frame;
+
+	led_frame_init(&frame);
+	led_wakeups_count();
+	if (!led_job_step(job, &frame)) {
+		k_timer_stop(timer);
+	}
+	led_frame_commit(&frame);
+}
+
+static void led_job_resume(struct led_job *job)
+{
+	k_timer_start(&job->timer, K_NO_WAIT, K_MSEC(job->sleep_ms));
+}
+
+static void led_timers_start(void)
+{
+	led_jobs_init();
+	for (size_t i = 0; i < led_jobs_len; i++) {
+		struct led_job *job = &led_jobs[i];
+		int64_t delay = MAX((int64_t)job->delay_ms - k_uptime_get(), 0);
+
+		k_timer_init(&job->timer, led_timer_expiry, NULL);
+		if (!job->follows_led1) {
+			k_timer_start(&job->timer, K_MSEC(delay), K_MSEC(job->sleep_ms));
+		}
+	}
+}
+
+#elif defined(CONFIG_APP_LED_ENGINE_SCHEDULER)
+
+/* Scheduler engine: one thread keeps the jobs in a min-heap ordered by deadline, sleeps until the
+ * earliest one and runs every step that is due, so LEDs whose periods line up (100 ms and
+ * 1000 ms) share a wakeup. Every blink() job's deadlines are multiples of its period counted from
+ * boot, so they line up whenever the periods do; they advance by exactly one period, so they
+ * don't drift. */
+static struct led_job *heap[ARRAY_SIZE(led_jobs)];
+static size_t heap_len;
+
+static void heap_push(struct led_job *job)
+{
+	size_t i = heap_len++;
+
+	while (i > 0 && heap[(i - 1) / 2]->due > job->due) {
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i] = job;
+}
+
+static struct led_job *heap_pop(void)
+{
+	struct led_job *top = heap[0];
+	struct led_job *last = heap[--heap_len];
+	size_t i = 0;
+
+	while (2 * i + 1 < heap_len) {
+		size_t child = 2 * i + 1;
+
+		if (child + 1 < heap_len && heap[child + 1]->due < heap[child]->due) {
+			child++;
+		}
+		if (last->due <= heap[child]->due) {
+			break;
+		}
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = last;
+	return top;
+}
+
+/* Deadline of the step led_scheduler() is running. */
+static int64_t step_due;
+
+/* Only called from led_scheduler(), via led_job_step(). The resumed job runs in the same wakeup,
+ * and takes the deadline of the step that resumed it so its own next one keeps the same phase. */
+static void led_job_resume(struct led_job *job)
+{
+	job->due = step_due;
+	heap_push(job);
+}
+
+void led_scheduler(void)
+{
+	k_event_wait(&events, EVENT_INIT_DONE, false, K_FOREVER);
+
+	led_jobs_init();
+	for (size_t i = 0; i < led_jobs_len; i++) {
+		struct led_job *job = &led_jobs[i];
+
+		if (!job->follows_led1) {
+			// The first multiple of the period after the start delay and now, rather than
+			// now itself, which would put each LED on its own phase.
+			int64_t start = MAX((int64_t)job->delay_ms, k_uptime_get());
+
+			job->due = DIV_ROUND_UP(start, job->sleep_ms) * job->sleep_ms;
+			heap_push(job);
+		}
+	}
+
+	while (1) {
+		struct led_frame frame;
+		int64_t now;
+
+		// Only a blink() job (LED1's) can start the blink_event() ones, so with none there is
+		// nothing left to do.
+		if (heap_len == 0) {
+			return;
+		}
+		k_sleep(K_TIMEOUT_ABS_MS(heap[0]->due));
+		led_wakeups_count();
+
+		// LEDs due in the same wakeup change together, with one write per GPIO port.
+		led_frame_init(&frame);
+		now = k_uptime_get();
+		while (heap_len > 0 && heap[0]->due <= now) {
+			struct led_job *job = heap_pop();
+
+			step_due = job->due;
+			if (led_job_step(job, &frame)) {
+				job->due += job->sleep_ms;
+				heap_push(job);
+			}
+		}
+		led_frame_commit(&frame);
+	}
+}
+
+#elif defined(CONFIG_APP_LED_ENGINE_WORKQUEUE)
+
+/* Workqueue engine: each job is a delayable work item on one workqueue thread at PRIORITY_LEDS.
+ * blink() jobs reschedule themselves for their next period_next() deadline, so they are timed
+ * like the blink threads and fill in the same led_period_stats_get(). */
+static K_THREAD_STACK_DEFINE(led_workq_stack, STACKSIZE);
+static struct k_work_q led_workq;
+
+/* Written only by the workqueue thread; max_runtime in cycles. */
+static struct {
+	uint32_t depth;
+	uint32_t max_depth;
+	uint32_t max_runtime;
+} led_work_stats;
+
+/* Jobs waiting on the queue behind the one that is running. */
+static uint32_t led_work_queued(void)
+{
+	uint32_t queued = 0;
+
+	for (size_t i = 0; i < led_jobs_len; i++) {
+		queued += (k_work_delayable_busy_get(&led_jobs[i].work) & K_WORK_QUEUED) != 0;
+	}
+	return queued;
+}
+
+static void led_work_handler(struct k_work *work)
+{
+	struct led_job *job = CONTAINER_OF(k_work_delayable_from_work(work), struct led_job, work);
+	struct period *period = &blink_periods[led_num(job->led)];
+	uint32_t start = k_cycle_get_32();
+	struct led_frame frame;
+
+	led_work_stats.depth = led_work_queued();
+	led_work_stats.max_depth = MAX(led_work_stats.max_depth, led_work_stats.depth);
+
+	if (!job->follows_led1) {
+		if (job->cnt == 0) {
+			period_start(period, job->sleep_ms);
+		} else {
+			period_arrived(period);
+		}
+	}
+	led_wakeups_count();
+
+	led_frame_init(&frame);
+	if (led_job_step(job, &frame)) {
+		k_work_schedule_for_queue(&led_workq, &job->work,
+					  job->follows_led1
+						  ? K_MSEC(job->sleep_ms)
+						  : K_TIMEOUT_ABS_TICKS(period_next(period)));
+	}
+	led_frame_commit(&frame);
+
+	led_work_stats.max_runtime = MAX(led_work_stats.max_runtime, k_cycle_get_32() - start);
+}
+
+/* Only called from the workqueue, via led_job_step(). */
+static void led_job_resume(struct led_job *job)
+{
+	k_work_reschedule_for_queue(&led_workq, &job->work, K_NO_WAIT);
+}
+
+static void led_works_start(void)
+{
+	const struct k_work_queue_config config = {.name = "led_workq"};
+
+	led_jobs_init();
+	k_work_queue_start(&led_workq, led_workq_stack, K_THREAD_STACK_SIZEOF(led_workq_stack),
+			   PRIORITY_LEDS, &config);
+
+	for (size_t i = 0; i < led_jobs_len; i++) {
+		struct led_job *job = &led_jobs[i];
+		int64_t delay = MAX((int64_t)job->delay_ms - k_uptime_get(), 0);
+
+		k_work_init_delayable(&job->work, led_work_handler);
+		if (!job->follows_led1) {
+			k_work_schedule_for_queue(&led_workq, &job->work, K_MSEC(delay));
+		}
+	}
+}
+
+int led_work_stats_get(struct led_work_stats *stats)
+{
+	stats->depth = led_work_stats.depth;
+	stats->max_depth = led_work_stats.max_depth;
+	stats->max_runtime_us = k_cyc_to_us_floor32(led_work_stats.max_runtime);
+	return 0;
+}
+
+#elif defined(CONFIG_APP_LED_ENGINE_STACKLESS)
+
+/* Stackless engine: blink(), blink_event() and blink_noyield() rewritten as stackless tasks
+ * (src/coro.h), all on one executor thread. A task keeps in struct led_task what the thread
+ * versions keep in locals. */
+struct led_task {
+	struct coro co;
+	const struct led *led;
+	uint32_t sleep_ms;
+	uint32_t cnt;
+	uint32_t led1_rises; /* blink_event_task(): the LED1 rising edge it waits to be passed */
+};
+
+static struct led_task led_tasks[ARRAY_SIZE(leds)];
+static struct coro *led_coros[ARRAY_SIZE(leds)];
+static struct coro_exec led_exec;
+static uint32_t led1_rises; /* only touched by the executor thread */
+
+static void led_task_toggle(struct led_task *t)
+{
+	bool on = t->cnt % 2;
+
+	gpio_pin_set(t->led->spec.port, t->led->spec.pin, on);
+	led_toggled(t->led);
+	boot_phase_mark(BOOT_PHASE_FIRST_TOGGLE);
+
+	telemetry_publish(led_num(t->led), t->cnt, k_cycle_get_32());
+	if (t->led == &leds[1]) {
+		led1_published(t->cnt);
+		led1_rises += on;
+	}
+	t->cnt++;
+}
+
+static enum coro_state blink_task(struct coro *co)
+{
+	struct led_task *t = CONTAINER_OF(co, struct led_task, co);
+
+	CORO_BEGIN(co);
+	while (1) {
+		led_task_toggle(t);
+		// Deadlines advance by exactly one period, as with period_wait().
+		CORO_SLEEP_UNTIL(co, co->due + t->sleep_ms);
+		led_wakeups_count();
+	}
+	CORO_END(co);
+}
+
+static enum coro_state blink_event_task(struct coro *co)
+{
+	struct led_task *t = CONTAINER_OF(co, struct led_task, co);
+
+	CORO_BEGIN(co);
+	CORO_WAIT_UNTIL(co, k_event_test(&events, EVENT_LED1_ON));
+	while (1) {
+		// As k_event_wait() with reset=true: wait for LED1's next rising edge.
+		if (t->cnt % 2) {
+			t->led1_rises = led1_rises;
+			CORO_WAIT_UNTIL(co, led1_rises != t->led1_rises);
+			led_wakeups_count();
+		}
+		led_task_toggle(t);
+		CORO_SLEEP_UNTIL(co, k_uptime_get_32() + t->sleep_ms);
+		led_wakeups_count();
+	}
+	CORO_END(co);
+}
+
+/* Yields after every toggle, so unlike blink_noyield() it shares the executor with the other
+ * tasks; the executor never sleeps while it runs, though. */
+static enum coro_state blink_busy_task(struct coro *co)
+{
+	struct led_task *t = CONTAINER_OF(co, struct led_task, co);
+
+	CORO_BEGIN(co);
+	boot_phase_mark(BOOT_PHASE_FIRST_TOGGLE);
+	while (1) {
+		gpio_pin_set(t->led->spec.port, t->led->spec.pin, t->cnt % 2);
+		activity[t->led - leds].spins = ++t->cnt;
+		CORO_YIELD(co);
+	}
+	CORO_END(co);
+}
+
+void led_executor(void)
+{
+	static const coro_fn_t task_fns[] = {
+		[LED_MODE_BLINK] = blink_task,
+		[LED_MODE_FOLLOW_LED1] = blink_event_task,
+		[LED_MODE_BUSY] = blink_busy_task,
+	};
+	size_t len = 0;
+
+	k_event_wait(&events, EVENT_INIT_DONE, false, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(leds); i++) {
+		struct led_role role = led_role(i);
+		struct led_task *t = &led_tasks[len];
+
+		if (role.mode == LED_MODE_OFF || !led_is_ready(&leds[i])) {
+			continue;
+		}
+		t->led = &leds[i];
+		t->sleep_ms = role.period_ms;
+		coro_init(&t->co, task_fns[role.mode], MAX(role.delay_ms, k_uptime_get_32()));
+		led_coros[len++] = &t->co;
+	}
+
+	coro_exec_init(&led_exec, led_coros, len);
+	coro_exec_run(&led_exec);
+}
+
+#else
+
 /* Helper function to pass arguments to blink(). Especially useful if a thread needs more than three
  * arguments */
 void blink0(void)
 {
-	blink(&led0, 100, 0);
+	blink(&leds[0], 100, 0);
 }
 
-/* UART helper. Separating UART into a separate task allows printk() to run at higher or lower
- * priority, as desired. */
-void uart_out(void)
+#endif /* CONFIG_APP_LED_ENGINE_* */
+
+#ifndef CONFIG_APP_LED_ENGINE_WORKQUEUE
+int led_work_stats_get(struct led_work_stats *stats)
 {
-	while (1) {
-		struct printk_data_t *rx_data = k_fifo_get(&printk_fifo, K_FOREVER);
-		printk("Toggled led%d; counter=%d\n", rx_data->led, rx_data->cnt);
-		k_free(rx_data);
-	}
+	return -ENOTSUP;
 }
+#endif
 
 // Initialization
 K_THREAD_DEFINE(init_id, STACKSIZE, init, NULL, NULL, NULL, PRIORITY_INIT, 0, 0);
 K_THREAD_DEFINE(uart_out_id, STACKSIZE, uart_out, NULL, NULL, NULL, PRIORITY_UART, 0, 0);
 
+#if defined(CONFIG_APP_LED_ENGINE_THREADS)
 // Use a helper function to start a thread
 K_THREAD_DEFINE(blink0_id, STACKSIZE, blink0, NULL, NULL, NULL, PRIORITY_LEDS, 0, 0);
 // Start a thread with arguments and a delay
-K_THREAD_DEFINE(blink1_id, STACKSIZE, blink, &led1, 1000, 1, PRIORITY_LEDS, 0, 5000);
+K_THREAD_DEFINE(blink1_id, STACKSIZE, blink, &leds[1], 1000, 1, PRIORITY_LEDS, 0, 5000);
 
 // blink_event uses Event messaging to blink when LED1 is on.
-K_THREAD_DEFINE(blink2_id, STACKSIZE, blink_event, &led2, 200, 2, PRIORITY_LEDS, 0, 0);
+K_THREAD_DEFINE(blink2_id, STACKSIZE, blink_event, &leds[2], 200, 2, PRIORITY_LEDS, 0, 0);
+#elif defined(CONFIG_APP_LED_ENGINE_SCHEDULER)
+// One thread drives LED0-LED2.
+K_THREAD_DEFINE(led_scheduler_id, STACKSIZE, led_scheduler, NULL, NULL, NULL, PRIORITY_LEDS, 0, 0);
+#elif defined(CONFIG_APP_LED_ENGINE_STACKLESS)
+// One thread runs every LED's task, LED3's busy loop included.
+K_THREAD_DEFINE(led_executor_id, STACKSIZE, led_executor, NULL, NULL, NULL, PRIORITY_LEDS, 0, 0);
+#endif
 
 // The following examples use LED3 to demonstrate task blocking and prioritization.
 
 // ========================================================
-// Priority and preemption examples
+// Priority and preemption examples, selected with CONFIG_APP_SCENARIO and measured with
+// CONFIG_APP_SCENARIO_REPORT_INTERVAL_MS.
 
+#if defined(CONFIG_APP_SCENARIO_HIGH_BUSY)
 // High-priority busy thread
 // A delay of 0 means this thread never sleeps. When thread priority > PRIORITY, Zephyr will only
 // ever run this thread.
-// K_THREAD_DEFINE(blink3_id, STACKSIZE, blink, &led3, 0, 3, PRIORITY_LEDS-1, 0, 0);
+#define SCENARIO_NAME     "high_busy"
+#define SCENARIO_ID       LED_SCENARIO_HIGH_BUSY
+#define SCENARIO_ENTRY    blink
+#define SCENARIO_SLEEP_MS 0
+#define SCENARIO_PRIORITY (PRIORITY_LEDS - 1)
 
+#elif defined(CONFIG_APP_SCENARIO_EQUAL_YIELD)
 // If priority is the same as peer threads, Zephyr will rotate the busy thread out when it yields or
 // sleeps. (specifically, Zephyr rotates round-robin between same-priority threads) Provided a
 // thread yields often, it won't disrupt other threads doing light work.
-// K_THREAD_DEFINE(blink3_id, STACKSIZE, blink, &led3, 0, 3, PRIORITY_LEDS, 0, 0);
+#define SCENARIO_NAME     "equal_yield"
+#define SCENARIO_ID       LED_SCENARIO_EQUAL_YIELD
+#define SCENARIO_ENTRY    blink
+#define SCENARIO_SLEEP_MS 0
+#define SCENARIO_PRIORITY PRIORITY_LEDS
 
+#elif defined(CONFIG_APP_SCENARIO_LOW_YIELD)
 // If a busy thread is lower priority than others, Zephyr will automatically swap it out when higher
 // priority tasks become ready. The low priority thread doesn't need to yield or sleep; Zephyr will
 // notice the higher priority thread is ready on a system tick. If the other tasks were using more
 // CPU time LED3 would stop blinking whenever another task had importatnt work to do. (you can
 // probably see the UART task interrupting LED3's blinking with an oscilloscope)
-// K_THREAD_DEFINE(blink3_id, STACKSIZE, blink, &led3, 0, 3, PRIORITY_LEDS+1, 0, 0);
+#define SCENARIO_NAME     "low_yield"
+#define SCENARIO_ID       LED_SCENARIO_LOW_YIELD
+#define SCENARIO_ENTRY    blink
+#define SCENARIO_SLEEP_MS 0
+#define SCENARIO_PRIORITY (PRIORITY_LEDS + 1)
 
+#elif defined(CONFIG_APP_SCENARIO_EQUAL_NOYIELD)
+// But it won't swap equal priority threads. If a non-yielding or long-running thread is the same
+// priority as others, Zephyr will let it run forever.
+#define SCENARIO_NAME     "equal_noyield"
+#define SCENARIO_ID       LED_SCENARIO_EQUAL_NOYIELD
+#define SCENARIO_ENTRY    blink_noyield
+#define SCENARIO_SLEEP_MS 1000
+#define SCENARIO_PRIORITY PRIORITY_LEDS
+
+#elif defined(CONFIG_APP_SCENARIO_LOW_NOYIELD)
 // Zephyr is preemptive. It'll swap out a low priority thread even if the thread never yields or
 // invokes the kernel.
-K_THREAD_DEFINE(blink3_id, STACKSIZE, blink_noyield, &led3, 1000, 3, PRIORITY_LEDS + 1, 0, 0);
+#define SCENARIO_NAME     "low_noyield"
+#define SCENARIO_ID       LED_SCENARIO_LOW_NOYIELD
+#define SCENARIO_ENTRY    blink_noyield
+#define SCENARIO_SLEEP_MS 1000
+#define SCENARIO_PRIORITY (PRIORITY_LEDS + 1)
+#endif
 
-// But it won't swap equal priority threads. If a non-yielding or long-running thread is the same
-// priority as others, Zephyr will let it run forever.
-// K_THREAD_DEFINE(blink3_id, STACKSIZE, blink_noyield, &led3, 1000, 3, PRIORITY_LEDS, 0, 0);
+#ifdef SCENARIO_NAME
+K_THREAD_DEFINE(blink3_id, STACKSIZE, SCENARIO_ENTRY, &leds[3], SCENARIO_SLEEP_MS, 3,
+		SCENARIO_PRIORITY, 0, 0);
+
+const char *led_scenario_name(void)
+{
+	return SCENARIO_NAME;
+}
+
+enum led_scenario led_scenario_id(void)
+{
+	return SCENARIO_ID;
+}
+#else
+const char *led_scenario_name(void)
+{
+	return "none";
+}
+
+enum led_scenario led_scenario_id(void)
+{
+	return LED_SCENARIO_NONE;
+}
+#endif
 
 // Thread options are documented here. There aren't many choices:
 // - save & restore FP registers
@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "period.h"
+#include "sched_trace.h"
+
+static struct k_spinlock lock;
+
+void period_start(struct period *p, uint32_t ms)
+{
+	p->start = k_uptime_ticks();
+	p->ms = MAX(ms, 1);
+	p->n = 0;
+	p->stats = (struct period_stats){0};
+}
+
+/* The @n th deadline, in ticks. */
+static int64_t period_deadline(const struct period *p, uint64_t n)
+{
+	return p->start + k_ms_to_ticks_floor64(n * p->ms);
+}
+
+int64_t period_next(struct period *p)
+{
+	int64_t deadline = period_deadline(p, p->n + 1);
+	int64_t now = k_uptime_ticks();
+	uint32_t missed = 0;
+	k_spinlock_key_t key;
+
+	// If the deadline after this one has passed as well, skip to the latest one that has. The
+	// tick to ms conversion can come out one short, hence the MAX().
+	if (period_deadline(p, p->n + 2) <= now) {
+		uint64_t passed = MAX(k_ticks_to_ms_floor64(now - p->start) / p->ms, p->n + 2);
+
+		missed = passed - (p->n + 1);
+		p->n += missed;
+		deadline = period_deadline(p, p->n + 1);
+	}
+	p->n++;
+	p->deadline = deadline;
+
+	key = k_spin_lock(&lock);
+	p->stats.missed += missed;
+	k_spin_unlock(&lock, key);
+	return deadline;
+}
+
+void period_arrived(struct period *p)
+{
+	int64_t now = k_uptime_ticks();
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	p->stats.periods++;
+	p->stats.drift_ticks = now - p->deadline;
+	p->stats.max_late_ticks = MAX(p->stats.max_late_ticks, p->stats.drift_ticks);
+	k_spin_unlock(&lock, key);
+}
+
+void period_wait(struct period *p)
+{
+	int64_t deadline = period_next(p);
+
+	sched_trace_record(SCHED_TRACE_SLEEP,
+			   k_ticks_to_ms_ceil64(MAX(deadline - k_uptime_ticks(), 0)));
+	k_sleep(K_TIMEOUT_ABS_TICKS(deadline));
+	sched_trace_record(SCHED_TRACE_WOKE, 0);
+	period_arrived(p);
+}
+
+void period_stats_get(const struct period *p, struct period_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*stats = p->stats;
+	k_spin_unlock(&lock, key);
+}
@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_PERIOD_H_
+#define APP_PERIOD_H_
+
+#include <zephyr/kernel.h>
+
+/* Periodic execution anchored to absolute deadlines: the Nth wakeup is due at start + N * period,
+ * however long the loop body ran or was preempted, so lateness never accumulates the way it does
+ * with a relative k_msleep() at the end of each iteration. The period is kept in milliseconds and
+ * each deadline rounded to a tick on its own, so a period that isn't a whole number of ticks
+ * (100 ms at 32768 Hz) doesn't add its rounding error every time.
+ */
+struct period_stats {
+	uint32_t periods;        /* deadlines waited for */
+	uint32_t missed;         /* deadlines skipped because the caller overran a whole period */
+	int64_t drift_ticks;     /* last wakeup minus its ideal time */
+	int64_t max_late_ticks;  /* worst drift_ticks so far */
+};
+
+struct period {
+	int64_t start; /* ticks */
+	uint32_t ms;
+	uint64_t n;
+	int64_t deadline; /* set by period_next() */
+	struct period_stats stats;
+};
+
+/* Start counting periods of @ms from now. */
+void period_start(struct period *p, uint32_t ms);
+
+/* Sleep until the next deadline. If that deadline has already passed by a whole period or more,
+ * the missed deadlines are counted and skipped rather than run back to back. */
+void period_wait(struct period *p);
+
+/* period_wait() in two halves, for callers that don't sleep in a thread of their own (such as
+ * work items): period_next() returns the next deadline in ticks, with missed ones skipped, and
+ * period_arrived() records how late the caller woke for it. */
+int64_t period_next(struct period *p);
+void period_arrived(struct period *p);
+
+/* Consistent copy of @p's statistics, from any thread. */
+void period_stats_get(const struct period *p, struct period_stats *stats);
+
+#endif /* APP_PERIOD_H_ */
@@ -0,0 +1,196 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench.h"
+#include "threads.h"
+
+#ifdef CONFIG_APP_BENCH_SCHED
+
+/* Scheduler scaling for the kernel benchmark image: the same measurements with 6 to
+ * CONFIG_APP_BENCH_SCHED_MAX_THREADS extra threads spread over SPREAD priorities below the
+ * benchmark, to compare the CONFIG_SCHED_* and CONFIG_WAITQ_* backends (see sample.yaml). Each
+ * result name carries the thread count, e.g. "sched_n64_ready_remove_insert".
+ */
+
+#define SPREAD   4
+#define SLEEP_MS 1
+
+#if defined(CONFIG_SCHED_SCALABLE)
+#define SCHED_BACKEND "scalable"
+#elif defined(CONFIG_SCHED_MULTIQ)
+#define SCHED_BACKEND "multiq"
+#else
+#define SCHED_BACKEND "dumb"
+#endif
+
+#if defined(CONFIG_WAITQ_SCALABLE)
+#define WAITQ_BACKEND "scalable"
+#else
+#define WAITQ_BACKEND "dumb"
+#endif
+
+static const uint32_t counts[] = {6, 16, 32, 64, 128, 256, 512};
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, CONFIG_APP_BENCH_SCHED_MAX_THREADS,
+				   CONFIG_APP_BENCH_SCHED_STACK_SIZE);
+static struct k_thread threads[CONFIG_APP_BENCH_SCHED_MAX_THREADS];
+
+static K_THREAD_STACK_DEFINE(peer_stack, CONFIG_APP_BENCH_SCHED_STACK_SIZE);
+static struct k_thread peer;
+
+static K_SEM_DEFINE(crowd, 0, K_SEM_MAX_LIMIT);
+static K_SEM_DEFINE(ping, 0, 1);
+
+/* Always ready, but below the benchmark's priority so it never gets to run. */
+static void spinner(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		k_yield();
+	}
+}
+
+/* Like blink(): wake every @p1 ms, do next to nothing, sleep again. */
+static void sleeper(void *p1, void *p2, void *p3)
+{
+	uint32_t period_ms = (uintptr_t)p1;
+
+	while (1) {
+		k_msleep(period_ms);
+	}
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		k_sem_take(&crowd, K_FOREVER);
+	}
+}
+
+static void sem_giver(void *p1, void *p2, void *p3)
+{
+	uint32_t n = (uintptr_t)p1;
+
+	for (uint32_t i = 0; i <= n; i++) {
+		k_sem_give(&ping);
+	}
+}
+
+static void spawn(uint32_t n, k_thread_entry_t entry)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], K_THREAD_STACK_SIZEOF(stacks[i]), entry,
+				(void *)(uintptr_t)(1 + i % 8), NULL, NULL, PRIORITY_LEDS + i % SPREAD,
+				0, K_NO_WAIT);
+	}
+}
+
+static void reap(uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		k_thread_abort(&threads[i]);
+	}
+}
+
+static void result(uint32_t n, const char *what, uint32_t ops, uint64_t cycles)
+{
+	char name[48];
+
+	snprintk(name, sizeof(name), "sched_n%u_%s", n, what);
+	bench_report(name, ops, cycles);
+}
+
+/* Suspending and resuming one of @n ready threads: a ready queue remove and insert. */
+static void bench_ready(uint32_t n, uint32_t iterations)
+{
+	struct k_thread *target = &threads[n - 1];
+	timing_t start, end;
+
+	spawn(n, spinner);
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < iterations; i++) {
+		k_thread_suspend(target);
+		k_thread_resume(target);
+	}
+	end = timing_counter_get();
+	reap(n);
+	result(n, "ready_remove_insert", iterations, timing_cycles_get(&start, &end));
+}
+
+/* Waking the best of @n threads pending on one semaphore. The woken threads are lower priority,
+ * so each give is only the wait queue removal; they re-pend while the benchmark sleeps. */
+static void bench_waitq(uint32_t n, uint32_t iterations)
+{
+	uint64_t cycles = 0;
+	uint32_t ops = 0;
+
+	spawn(n, waiter);
+	k_msleep(10);
+	while (ops < iterations) {
+		timing_t start, end;
+
+		start = timing_counter_get();
+		for (uint32_t i = 0; i < n; i++) {
+			k_sem_give(&crowd);
+		}
+		end = timing_counter_get();
+		cycles += timing_cycles_get(&start, &end);
+		ops += n;
+		k_msleep(10);
+	}
+	reap(n);
+	result(n, "sem_give_waiters", ops, cycles);
+}
+
+/* With @n blink-like threads sleeping and waking: k_msleep() wakeup lateness, and a semaphore
+ * ping-pong with a peer just below the benchmark (two context switches per op). */
+static void bench_busy_timeouts(uint32_t n, uint32_t iterations)
+{
+	uint64_t total = 0;
+	uint64_t max = 0;
+	timing_t start, end;
+
+	spawn(n, sleeper);
+
+	for (uint32_t i = 0; i < CONFIG_APP_BENCH_SLEEP_ITERATIONS; i++) {
+		uint64_t cycles;
+
+		start = timing_counter_get();
+		k_msleep(SLEEP_MS);
+		end = timing_counter_get();
+		cycles = timing_cycles_get(&start, &end);
+		total += cycles;
+		max = MAX(max, cycles);
+	}
+	result(n, "msleep_1ms", CONFIG_APP_BENCH_SLEEP_ITERATIONS, total);
+	result(n, "msleep_1ms_max", 1, max);
+
+	k_thread_create(&peer, peer_stack, K_THREAD_STACK_SIZEOF(peer_stack), sem_giver,
+			(void *)(uintptr_t)iterations, NULL, NULL, PRIORITY_LEDS - 1, 0, K_NO_WAIT);
+	k_sem_take(&ping, K_FOREVER);
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < iterations; i++) {
+		k_sem_take(&ping, K_FOREVER);
+	}
+	end = timing_counter_get();
+	k_thread_join(&peer, K_FOREVER);
+	result(n, "ctx_switch_round_trip", iterations, timing_cycles_get(&start, &end));
+
+	reap(n);
+}
+
+void sched_bench(uint32_t iterations)
+{
+	printk("BENCH sched backend=" SCHED_BACKEND " waitq=" WAITQ_BACKEND "\n");
+
+	for (size_t i = 0; i < ARRAY_SIZE(counts) && counts[i] <= ARRAY_SIZE(threads); i++) {
+		bench_ready(counts[i], iterations);
+		bench_waitq(counts[i], iterations);
+		bench_busy_timeouts(counts[i], iterations);
+	}
+}
+
+#endif /* CONFIG_APP_BENCH_SCHED */
@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+
+#include "sched_trace.h"
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_APP_SCHED_TRACE_RECORDS),
+	     "CONFIG_APP_SCHED_TRACE_RECORDS must be a power of two");
+BUILD_ASSERT(CONFIG_APP_SCHED_TRACE_MAX_THREADS < UINT8_MAX);
+
+/* Thread index for threads beyond CONFIG_APP_SCHED_TRACE_MAX_THREADS. */
+#define THREAD_OTHER UINT8_MAX
+
+/* Records per TRACE DATA line. */
+#define LINE_RECORDS 8
+
+struct record {
+	uint32_t stamp;
+	uint8_t event;
+	uint8_t thread;
+	uint16_t arg;
+};
+
+static struct record ring[CONFIG_APP_SCHED_TRACE_RECORDS];
+static atomic_t head; /* records ever claimed since the last dump */
+static atomic_t recording = ATOMIC_INIT(1);
+
+/* Threads by index, claimed the first time each is seen. */
+static atomic_ptr_t threads[CONFIG_APP_SCHED_TRACE_MAX_THREADS];
+
+static uint8_t thread_index(k_tid_t tid)
+{
+	for (uint8_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		atomic_ptr_val_t seen = atomic_ptr_get(&threads[i]);
+
+		if (seen == tid) {
+			return i;
+		}
+		// Claim the first free slot. Whoever loses the race to it (an ISR, or the thread
+		// it interrupted) checks whether the winner was the same thread.
+		if (seen == NULL &&
+		    (atomic_ptr_cas(&threads[i], NULL, tid) || atomic_ptr_get(&threads[i]) == tid)) {
+			return i;
+		}
+	}
+	return THREAD_OTHER;
+}
+
+void sched_trace_record(enum sched_trace_event event, uint32_t arg)
+{
+	uint32_t stamp = k_cycle_get_32();
+	struct record *rec;
+
+	if (!atomic_get(&recording)) {
+		return;
+	}
+
+	rec = &ring[atomic_inc(&head) & (ARRAY_SIZE(ring) - 1)];
+	rec->stamp = stamp;
+	rec->event = event;
+	rec->thread = thread_index(k_current_get());
+	rec->arg = MIN(arg, UINT16_MAX);
+}
+
+/* Little-endian whatever the target, so the host needn't know. */
+static char *hex_record(char *out, const struct record *rec)
+{
+	static const char digits[] = "0123456789abcdef";
+	uint8_t bytes[] = {
+		rec->stamp, rec->stamp >> 8, rec->stamp >> 16, rec->stamp >> 24,
+		rec->event, rec->thread,     rec->arg,         rec->arg >> 8,
+	};
+
+	for (size_t i = 0; i < sizeof(bytes); i++) {
+		*out++ = digits[bytes[i] >> 4];
+		*out++ = digits[bytes[i] & 0xf];
+	}
+	return out;
+}
+
+/* Output, for scripts/sched_trace.py:
+ *
+ *   TRACE BEGIN hz=<cycles per second> records=<n> lost=<overwritten>
+ *   TRACE THREAD <index> prio=<priority> <name>
+ *   TRACE DATA <hex, LINE_RECORDS records per line>
+ *   TRACE END
+ */
+void sched_trace_dump(void)
+{
+	char line[LINE_RECORDS * sizeof(struct record) * 2 + 1];
+	uint32_t claimed;
+	uint32_t count;
+	uint32_t first;
+
+	atomic_set(&recording, 0);
+	claimed = atomic_get(&head);
+	count = MIN(claimed, ARRAY_SIZE(ring));
+	first = claimed - count;
+
+	printk("TRACE BEGIN hz=%u records=%u lost=%u\n", sys_clock_hw_cycles_per_sec(), count,
+	       claimed - count);
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		k_tid_t tid = atomic_ptr_get(&threads[i]);
+		const char *name;
+
+		if (tid == NULL) {
+			break;
+		}
+		name = k_thread_name_get(tid);
+		printk("TRACE THREAD %u prio=%d %s\n", i, k_thread_priority_get(tid),
+		       (name != NULL && name[0] != '\0') ? name : "?");
+	}
+
+	for (uint32_t i = 0; i < count; i += LINE_RECORDS) {
+		char *out = line;
+
+		for (uint32_t j = i; j < MIN(i + LINE_RECORDS, count); j++) {
+			out = hex_record(out, &ring[(first + j) & (ARRAY_SIZE(ring) - 1)]);
+		}
+		*out = '\0';
+		printk("TRACE DATA %s\n", line);
+	}
+	printk("TRACE END\n");
+
+	atomic_set(&head, 0);
+	atomic_set(&recording, 1);
+}
+
+#if CONFIG_APP_SCHED_TRACE_DUMP_MS > 0
+static void dump_work_handler(struct k_work *work)
+{
+	sched_trace_dump();
+}
+static K_WORK_DELAYABLE_DEFINE(dump_work, dump_work_handler);
+
+static int sched_trace_setup(void)
+{
+	k_work_schedule(&dump_work, K_MSEC(CONFIG_APP_SCHED_TRACE_DUMP_MS));
+	return 0;
+}
+SYS_INIT(sched_trace_setup, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif
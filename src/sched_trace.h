@@ -0,0 +1,56 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_SCHED_TRACE_H_
+#define APP_SCHED_TRACE_H_
+
+#include <stdint.h>
+
+/* Scheduler tracing into a RAM ring buffer (CONFIG_APP_SCHED_TRACE), for a timeline of which
+ * thread ran when without an oscilloscope on the LEDs.
+ *
+ * Context switches and ISRs come from the kernel's user tracing hooks. The kernel has no such
+ * hooks for k_fifo, k_event or k_sleep(), so the application records its own calls to them where
+ * it makes them. Each record is 8 bytes: a k_cycle_get_32() stamp, the event, a small index for
+ * the current thread and a 16-bit argument. When the buffer is full the oldest records are
+ * overwritten.
+ *
+ * sched_trace_dump() prints the buffer as TRACE lines; scripts/sched_trace.py turns a console
+ * capture holding them into a Perfetto (Chrome JSON) or CTF timeline.
+ */
+
+/* Keep in step with EVENTS in scripts/sched_trace.py. */
+enum sched_trace_event {
+	SCHED_TRACE_SWITCH_IN = 1, /* the current thread was switched in */
+	SCHED_TRACE_SWITCH_OUT,    /* ... and out */
+	SCHED_TRACE_ISR_ENTER,     /* arg: nesting level */
+	SCHED_TRACE_ISR_EXIT,
+	SCHED_TRACE_FIFO_PUT, /* arg: LED number of the record */
+	SCHED_TRACE_FIFO_GET,
+	SCHED_TRACE_EVENT_SET,  /* arg: the bits set; for a masked set, their new value */
+	SCHED_TRACE_EVENT_WAIT, /* arg: the bits waited for */
+	SCHED_TRACE_EVENT_WOKE,
+	SCHED_TRACE_SLEEP, /* arg: ms until the wakeup is due */
+	SCHED_TRACE_WOKE,
+};
+
+#ifdef CONFIG_APP_SCHED_TRACE
+/* Append a record for the current thread (the interrupted one, from an ISR). Callable from any
+ * context, including the tracing hooks themselves. */
+void sched_trace_record(enum sched_trace_event event, uint32_t arg);
+
+/* Print everything recorded since boot or the last dump, oldest first, then start over. Recording
+ * pauses meanwhile, so the dump doesn't trace itself. */
+void sched_trace_dump(void);
+#else
+static inline void sched_trace_record(enum sched_trace_event event, uint32_t arg)
+{
+}
+
+static inline void sched_trace_dump(void)
+{
+}
+#endif
+
+#endif /* APP_SCHED_TRACE_H_ */
@@ -0,0 +1,390 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "sched_trace.h"
+#include "telemetry.h"
+
+/* Per-LED accounting, common to every transport. */
+static struct {
+	atomic_t published;
+	atomic_t alloc_failures;
+	atomic_t dropped;
+	atomic_t depth;
+	atomic_t max_depth;
+} led_stats[CONFIG_APP_TELEMETRY_MAX_LEDS];
+
+/* How long a blink thread may wait for room before its record is dropped. */
+#if defined(CONFIG_APP_TELEMETRY_BACKPRESSURE_BLOCK)
+#define PUBLISH_TIMEOUT K_FOREVER
+#elif defined(CONFIG_APP_TELEMETRY_BACKPRESSURE_RETRY)
+#define PUBLISH_TIMEOUT K_MSEC(CONFIG_APP_TELEMETRY_RETRY_TIMEOUT_MS)
+#else
+#define PUBLISH_TIMEOUT K_NO_WAIT
+#endif
+
+static void account_queued(uint32_t led)
+{
+	atomic_val_t depth;
+	atomic_val_t max;
+
+	if (led >= ARRAY_SIZE(led_stats)) {
+		return;
+	}
+	depth = atomic_inc(&led_stats[led].depth) + 1;
+	max = atomic_get(&led_stats[led].max_depth);
+	while (depth > max && !atomic_cas(&led_stats[led].max_depth, max, depth)) {
+		max = atomic_get(&led_stats[led].max_depth);
+	}
+}
+
+static void account_dequeued(uint32_t led)
+{
+	if (led < ARRAY_SIZE(led_stats)) {
+		atomic_dec(&led_stats[led].depth);
+	}
+}
+
+static void account_dropped(uint32_t led)
+{
+	if (led < ARRAY_SIZE(led_stats)) {
+		atomic_inc(&led_stats[led].dropped);
+	}
+}
+
+#if defined(CONFIG_APP_TELEMETRY_FIFO)
+
+/* Queue node for the k_fifo backend. */
+struct printk_data_t {
+	void *fifo_reserved; /* 1st word reserved for use by fifo */
+	struct telemetry_record rec;
+};
+
+/* Telemetry records are all the same size, so a slab beats the general-purpose heap: allocation
+ * and free are a pointer swap under a spinlock, and the pool can never fragment. */
+K_MEM_SLAB_DEFINE_STATIC(telemetry_slab, sizeof(struct printk_data_t),
+			 CONFIG_APP_TELEMETRY_POOL_SIZE, sizeof(void *));
+K_FIFO_DEFINE(printk_fifo);
+
+static atomic_t alloc_failures;
+
+static int transport_put(const struct telemetry_record *rec, k_timeout_t timeout)
+{
+	struct printk_data_t *tx_data;
+
+	if (k_mem_slab_alloc(&telemetry_slab, (void **)&tx_data, timeout) != 0) {
+		atomic_inc(&alloc_failures);
+		return -ENOMEM;
+	}
+	tx_data->rec = *rec;
+	// Recorded first: a waiting uart_out() preempts the blink thread inside k_fifo_put().
+	sched_trace_record(SCHED_TRACE_FIFO_PUT, rec->led);
+	k_fifo_put(&printk_fifo, tx_data);
+	return 0;
+}
+
+static int transport_get(struct telemetry_record *rec, k_timeout_t timeout)
+{
+	struct printk_data_t *rx_data = k_fifo_get(&printk_fifo, timeout);
+
+	if (rx_data == NULL) {
+		return -EAGAIN;
+	}
+	sched_trace_record(SCHED_TRACE_FIFO_GET, rx_data->rec.led);
+	*rec = rx_data->rec;
+	k_mem_slab_free(&telemetry_slab, rx_data);
+	return 0;
+}
+
+static void transport_poll_init(struct k_poll_event *evt)
+{
+	k_poll_event_init(evt, K_POLL_TYPE_FIFO_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+			  &printk_fifo);
+}
+
+static void transport_stats_get(struct telemetry_stats *stats)
+{
+	stats->used = k_mem_slab_num_used_get(&telemetry_slab);
+	stats->max_used = k_mem_slab_max_used_get(&telemetry_slab);
+	stats->dropped = atomic_get(&alloc_failures);
+}
+
+#elif defined(CONFIG_APP_TELEMETRY_RING)
+
+#include "telemetry_ring.h"
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_APP_TELEMETRY_RING_SIZE),
+	     "CONFIG_APP_TELEMETRY_RING_SIZE must be a power of two");
+
+static struct telemetry_ring_slot ring_slots[CONFIG_APP_TELEMETRY_RING_SIZE];
+static struct telemetry_ring ring;
+
+static void account_evicted(const struct telemetry_record *rec)
+{
+	account_dequeued(rec->led);
+	account_dropped(rec->led);
+}
+
+static int telemetry_ring_setup(void)
+{
+	telemetry_ring_init(&ring, ring_slots, ARRAY_SIZE(ring_slots),
+			    IS_ENABLED(CONFIG_APP_TELEMETRY_BACKPRESSURE_DROP_OLDEST)
+				    ? TELEMETRY_RING_DROP_OLDEST
+				    : TELEMETRY_RING_DROP_NEWEST,
+			    account_evicted);
+	return 0;
+}
+SYS_INIT(telemetry_ring_setup, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+static int transport_put(const struct telemetry_record *rec, k_timeout_t timeout)
+{
+	return telemetry_ring_put(&ring, rec, timeout);
+}
+
+static int transport_get(struct telemetry_record *rec, k_timeout_t timeout)
+{
+	return telemetry_ring_get(&ring, rec, timeout);
+}
+
+static void transport_poll_init(struct k_poll_event *evt)
+{
+	telemetry_ring_poll_init(&ring, evt);
+}
+
+static void transport_stats_get(struct telemetry_stats *stats)
+{
+	telemetry_ring_stats_get(&ring, stats);
+}
+
+#elif defined(CONFIG_APP_TELEMETRY_MAILBOX)
+
+/* One overwrite slot per LED holding its latest state. However far uart_out() falls behind, it
+ * only ever has one pending record per LED to report. */
+static struct {
+	uint32_t cnt;
+	uint32_t coalesced;
+	uint32_t stamp;
+} mailbox[CONFIG_APP_TELEMETRY_MAX_LEDS];
+
+static ATOMIC_DEFINE(mailbox_dirty, CONFIG_APP_TELEMETRY_MAX_LEDS);
+static struct k_spinlock mailbox_lock;
+static K_SEM_DEFINE(mailbox_sem, 0, 1);
+static atomic_t mailbox_dropped;
+static atomic_t mailbox_max_used;
+static uint32_t next_slot; /* round-robin scan start, so a busy LED can't starve the others */
+
+/* Never waits. Returns -EALREADY if @rec replaced a record that hadn't been reported yet. */
+static int transport_put(const struct telemetry_record *rec, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	bool was_dirty;
+
+	if (rec->led >= ARRAY_SIZE(mailbox)) {
+		atomic_inc(&mailbox_dropped);
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&mailbox_lock);
+	was_dirty = atomic_test_and_set_bit(mailbox_dirty, rec->led);
+	if (was_dirty) {
+		mailbox[rec->led].coalesced++;
+		atomic_inc(&mailbox_dropped);
+	}
+	mailbox[rec->led].cnt = rec->cnt;
+	mailbox[rec->led].stamp = rec->stamp;
+	k_spin_unlock(&mailbox_lock, key);
+
+	if (was_dirty) {
+		return -EALREADY;
+	}
+	k_sem_give(&mailbox_sem);
+	return 0;
+}
+
+static uint32_t mailbox_used(void)
+{
+	uint32_t used = 0;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(mailbox); i++) {
+		used += atomic_test_bit(mailbox_dirty, i);
+	}
+	return used;
+}
+
+static int transport_get(struct telemetry_record *rec, k_timeout_t timeout)
+{
+	while (1) {
+		uint32_t used = mailbox_used();
+
+		if (used > atomic_get(&mailbox_max_used)) {
+			atomic_set(&mailbox_max_used, used);
+		}
+
+		for (uint32_t i = 0; i < ARRAY_SIZE(mailbox); i++) {
+			uint32_t led = (next_slot + i) % ARRAY_SIZE(mailbox);
+			k_spinlock_key_t key;
+
+			if (!atomic_test_bit(mailbox_dirty, led)) {
+				continue;
+			}
+
+			key = k_spin_lock(&mailbox_lock);
+			atomic_clear_bit(mailbox_dirty, led);
+			rec->led = led;
+			rec->cnt = mailbox[led].cnt;
+			rec->coalesced = mailbox[led].coalesced;
+			rec->stamp = mailbox[led].stamp;
+			mailbox[led].coalesced = 0;
+			k_spin_unlock(&mailbox_lock, key);
+
+			next_slot = led + 1;
+			return 0;
+		}
+
+		if (k_sem_take(&mailbox_sem, timeout) != 0) {
+			return -EAGAIN;
+		}
+	}
+}
+
+/* mailbox_sem is given for each LED that goes from clean to dirty; transport_get() leaves its
+ * count behind when it finds a dirty slot without sleeping, hence the spurious wakeups. */
+static void transport_poll_init(struct k_poll_event *evt)
+{
+	k_poll_event_init(evt, K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &mailbox_sem);
+}
+
+static void transport_stats_get(struct telemetry_stats *stats)
+{
+	stats->used = mailbox_used();
+	stats->max_used = atomic_get(&mailbox_max_used);
+	stats->dropped = atomic_get(&mailbox_dropped);
+}
+
+#elif defined(CONFIG_APP_TELEMETRY_ZBUS)
+
+/* uart_out() gets its own copy of each record through a message subscriber, in a buffer from the
+ * zbus message pool. Listeners added elsewhere read the channel in place instead. */
+ZBUS_MSG_SUBSCRIBER_DEFINE(telemetry_sub);
+ZBUS_CHAN_DEFINE(led_state_chan, struct telemetry_record, NULL, NULL,
+		 ZBUS_OBSERVERS(telemetry_sub), ZBUS_MSG_INIT(0));
+
+static atomic_t zbus_used;
+static atomic_t zbus_max_used;
+static atomic_t zbus_dropped;
+
+/* Another publisher only ever holds the channel while copying a record and running the listeners,
+ * so threads wait for it rather than drop. Out of message buffers, zbus_chan_pub() returns -ENOMEM
+ * at once whatever the timeout. */
+static int transport_put(const struct telemetry_record *rec, k_timeout_t timeout)
+{
+	int ret = zbus_chan_pub(&led_state_chan, rec, k_is_in_isr() ? K_NO_WAIT : K_FOREVER);
+	atomic_val_t used;
+	atomic_val_t max;
+
+	if (ret != 0) {
+		atomic_inc(&zbus_dropped);
+		return ret;
+	}
+
+	used = atomic_inc(&zbus_used) + 1;
+	max = atomic_get(&zbus_max_used);
+	while (used > max && !atomic_cas(&zbus_max_used, max, used)) {
+		max = atomic_get(&zbus_max_used);
+	}
+	return 0;
+}
+
+static int transport_get(struct telemetry_record *rec, k_timeout_t timeout)
+{
+	const struct zbus_channel *chan;
+
+	if (zbus_sub_wait_msg(&telemetry_sub, &chan, rec, timeout) != 0) {
+		return -EAGAIN;
+	}
+	atomic_dec(&zbus_used);
+	return 0;
+}
+
+static void transport_poll_init(struct k_poll_event *evt)
+{
+	k_poll_event_init(evt, K_POLL_TYPE_FIFO_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+			  telemetry_sub.message_fifo);
+}
+
+static void transport_stats_get(struct telemetry_stats *stats)
+{
+	atomic_val_t used = atomic_get(&zbus_used);
+
+	stats->used = used > 0 ? used : 0;
+	stats->max_used = atomic_get(&zbus_max_used);
+	stats->dropped = atomic_get(&zbus_dropped);
+}
+
+#endif
+
+void telemetry_publish(uint32_t led, uint32_t cnt, uint32_t stamp)
+{
+	struct telemetry_record rec = {.led = led, .cnt = cnt, .stamp = stamp};
+	int ret = transport_put(&rec, k_is_in_isr() ? K_NO_WAIT : PUBLISH_TIMEOUT);
+
+	if (led < ARRAY_SIZE(led_stats)) {
+		atomic_inc(&led_stats[led].published);
+	}
+
+	switch (ret) {
+	case 0:
+		account_queued(led);
+		break;
+	case -EALREADY:
+		/* Coalesced: an older record was overwritten, the queue didn't grow. */
+		account_dropped(led);
+		break;
+	case -ENOMEM:
+		if (led < ARRAY_SIZE(led_stats)) {
+			atomic_inc(&led_stats[led].alloc_failures);
+		}
+		__fallthrough;
+	default:
+		account_dropped(led);
+		break;
+	}
+}
+
+int telemetry_get(struct telemetry_record *rec, k_timeout_t timeout)
+{
+	int ret = transport_get(rec, timeout);
+
+	if (ret == 0) {
+		account_dequeued(rec->led);
+	}
+	return ret;
+}
+
+void telemetry_poll_init(struct k_poll_event *evt)
+{
+	transport_poll_init(evt);
+}
+
+void telemetry_stats_get(struct telemetry_stats *stats)
+{
+	transport_stats_get(stats);
+}
+
+int telemetry_led_stats_get(uint32_t led, struct telemetry_led_stats *stats)
+{
+	if (led >= ARRAY_SIZE(led_stats)) {
+		return -EINVAL;
+	}
+
+	stats->published = atomic_get(&led_stats[led].published);
+	stats->alloc_failures = atomic_get(&led_stats[led].alloc_failures);
+	stats->dropped = atomic_get(&led_stats[led].dropped);
+	stats->depth = MAX(atomic_get(&led_stats[led].depth), 0);
+	stats->max_depth = atomic_get(&led_stats[led].max_depth);
+	return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_TELEMETRY_H_
+#define APP_TELEMETRY_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_APP_TELEMETRY_ZBUS
+#include <zephyr/zbus/zbus.h>
+#endif
+
+/* One "Toggled ledN" message, passed from the blink threads to uart_out(). */
+struct telemetry_record {
+	uint32_t led;
+	uint32_t cnt;
+	uint32_t coalesced; /* earlier updates overwritten by this one (mailbox transport only) */
+	uint32_t stamp;     /* k_cycle_get_32() when the LED was set */
+};
+
+struct telemetry_stats {
+	uint32_t used;     /* records queued and not yet consumed */
+	uint32_t max_used; /* high-water mark since boot */
+	uint32_t dropped;  /* records lost because the queue was full, or coalesced away */
+};
+
+/* Per-LED accounting, kept for LEDs below CONFIG_APP_TELEMETRY_MAX_LEDS. */
+struct telemetry_led_stats {
+	uint32_t published;      /* telemetry_publish() calls */
+	uint32_t alloc_failures; /* records lost because no buffer could be allocated */
+	uint32_t dropped;        /* records lost for any reason, including alloc_failures */
+	uint32_t depth;          /* records queued and not yet consumed */
+	uint32_t max_depth;      /* high-water mark of depth */
+};
+
+#ifdef CONFIG_APP_TELEMETRY_ZBUS
+/* The "led_state" channel: every published struct telemetry_record. Add observers with
+ * ZBUS_CHAN_ADD_OBS(); listeners run in the publisher's context, which may be an ISR. */
+ZBUS_CHAN_DECLARE(led_state_chan);
+#endif
+
+/* Producer side, called from the blink threads. When the queue is full this applies the
+ * CONFIG_APP_TELEMETRY_BACKPRESSURE policy: drop, retry for a bounded time, or block. From an ISR
+ * (the timer LED engine) the record is dropped instead of waiting. */
+void telemetry_publish(uint32_t led, uint32_t cnt, uint32_t stamp);
+
+/* Consumer side, called from uart_out(). Returns 0 and fills @rec, or -EAGAIN on timeout. */
+int telemetry_get(struct telemetry_record *rec, k_timeout_t timeout);
+
+/* Set up @evt for a consumer that k_poll()s the queue alongside other things. Once it is ready,
+ * call telemetry_get() with K_NO_WAIT until it returns -EAGAIN before polling again; it may also
+ * be ready with nothing left to read. */
+void telemetry_poll_init(struct k_poll_event *evt);
+
+void telemetry_stats_get(struct telemetry_stats *stats);
+
+/* Returns 0, or -EINVAL if @led has no statistics. */
+int telemetry_led_stats_get(uint32_t led, struct telemetry_led_stats *stats);
+
+#ifdef CONFIG_APP_BENCH_TELEMETRY_POOL
+/* Compare slab allocation of a record against k_malloc()/k_free(). */
+void telemetry_pool_bench(void);
+#endif
+
+#ifdef CONFIG_APP_BENCH_TELEMETRY_RING
+/* Compare the lock-free ring against the slab + k_fifo path. */
+void telemetry_ring_bench(void);
+#endif
+
+#endif /* APP_TELEMETRY_H_ */
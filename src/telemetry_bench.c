@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "bench.h"
+#include "telemetry.h"
+#include "telemetry_ring.h"
+
+/* The benchmarks build private copies of each transport so they can compare backends in one image,
+ * independent of which one CONFIG_APP_TELEMETRY_* selects for the application. */
+
+#define BATCH 8
+
+struct bench_node {
+	void *fifo_reserved;
+	struct telemetry_record rec;
+};
+
+#if defined(CONFIG_APP_BENCH_TELEMETRY_POOL) || defined(CONFIG_APP_BENCH_TELEMETRY_RING)
+K_MEM_SLAB_DEFINE_STATIC(bench_slab, sizeof(struct bench_node), BATCH, sizeof(void *));
+#endif
+
+#ifdef CONFIG_APP_BENCH_TELEMETRY_POOL
+void telemetry_pool_bench(void)
+{
+	const uint32_t n = CONFIG_APP_BENCH_ITERATIONS;
+	timing_t start, end;
+
+	timing_init();
+	timing_start();
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i++) {
+		struct bench_node *node;
+
+		k_mem_slab_alloc(&bench_slab, (void **)&node, K_NO_WAIT);
+		node->rec.cnt = i;
+		k_mem_slab_free(&bench_slab, node);
+	}
+	end = timing_counter_get();
+	bench_report("telemetry_slab_alloc_free", n, timing_cycles_get(&start, &end));
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i++) {
+		struct bench_node *node = k_malloc(sizeof(struct bench_node));
+
+		node->rec.cnt = i;
+		k_free(node);
+	}
+	end = timing_counter_get();
+	bench_report("telemetry_k_malloc_free", n, timing_cycles_get(&start, &end));
+
+}
+#endif /* CONFIG_APP_BENCH_TELEMETRY_POOL */
+
+#ifdef CONFIG_APP_BENCH_TELEMETRY_RING
+static K_FIFO_DEFINE(bench_fifo);
+static struct telemetry_ring_slot bench_slots[BATCH];
+static struct telemetry_ring bench_ring;
+
+/* Publish BATCH records and then drain them, so the consumer sees the same empty -> non-empty
+ * transitions it would under a bursty producer. */
+void telemetry_ring_bench(void)
+{
+	const uint32_t n = CONFIG_APP_BENCH_ITERATIONS / BATCH * BATCH;
+	struct telemetry_record rec = {0};
+	timing_t start, end;
+
+	timing_init();
+	timing_start();
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i += BATCH) {
+		for (uint32_t j = 0; j < BATCH; j++) {
+			struct bench_node *node;
+
+			k_mem_slab_alloc(&bench_slab, (void **)&node, K_NO_WAIT);
+			node->rec.cnt = i + j;
+			k_fifo_put(&bench_fifo, node);
+		}
+		for (uint32_t j = 0; j < BATCH; j++) {
+			struct bench_node *node = k_fifo_get(&bench_fifo, K_NO_WAIT);
+
+			rec = node->rec;
+			k_mem_slab_free(&bench_slab, node);
+		}
+	}
+	end = timing_counter_get();
+	bench_report("telemetry_fifo_put_get", n, timing_cycles_get(&start, &end));
+
+	telemetry_ring_init(&bench_ring, bench_slots, BATCH, TELEMETRY_RING_DROP_NEWEST, NULL);
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i += BATCH) {
+		for (uint32_t j = 0; j < BATCH; j++) {
+			rec.cnt = i + j;
+			telemetry_ring_put(&bench_ring, &rec, K_NO_WAIT);
+		}
+		for (uint32_t j = 0; j < BATCH; j++) {
+			telemetry_ring_get(&bench_ring, &rec, K_NO_WAIT);
+		}
+	}
+	end = timing_counter_get();
+	bench_report("telemetry_ring_put_get", n, timing_cycles_get(&start, &end));
+
+}
+#endif /* CONFIG_APP_BENCH_TELEMETRY_RING */
@@ -0,0 +1,114 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
+
+#include "telemetry_encode.h"
+
+/* Largest number of varint arguments a message may carry. */
+#define MSG_ARGS_MAX 6
+/* id + arguments (5 bytes each as LEB128) + CRC */
+#define MSG_RAW_MAX (1 + MSG_ARGS_MAX * 5 + 1)
+BUILD_ASSERT(MSG_RAW_MAX + 2 <= TELEMETRY_FRAME_MAX, "COBS adds one byte, plus the delimiter");
+
+/* LEDs with delta state. Records for higher LED numbers are always sent as keyframes. */
+#define DELTA_LEDS 32
+
+static struct {
+	uint32_t cnt;
+	uint8_t until_keyframe;
+} delta_state[DELTA_LEDS];
+
+static size_t put_varint(uint8_t *buf, uint32_t value)
+{
+	size_t len = 0;
+
+	do {
+		buf[len] = value & 0x7f;
+		value >>= 7;
+		if (value != 0) {
+			buf[len] |= 0x80;
+		}
+		len++;
+	} while (value != 0);
+	return len;
+}
+
+/* Consistent Overhead Byte Stuffing: rewrite @src without zero bytes and terminate with 0x00. */
+static size_t cobs_encode(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	size_t code_idx = 0;
+	size_t out = 1;
+	uint8_t code = 1;
+
+	for (size_t i = 0; i < len; i++) {
+		if (src[i] == 0) {
+			dst[code_idx] = code;
+			code_idx = out++;
+			code = 1;
+			continue;
+		}
+		dst[out++] = src[i];
+		if (++code == 0xff) {
+			dst[code_idx] = code;
+			code_idx = out++;
+			code = 1;
+		}
+	}
+	dst[code_idx] = code;
+	dst[out++] = 0;
+	return out;
+}
+
+size_t telemetry_encode_msg(uint8_t *buf, size_t size, uint8_t id, const uint32_t *args,
+			    size_t nargs)
+{
+	uint8_t raw[MSG_RAW_MAX];
+	size_t len = 0;
+
+	__ASSERT_NO_MSG(nargs <= MSG_ARGS_MAX);
+	if (size < TELEMETRY_FRAME_MAX) {
+		return 0;
+	}
+
+	raw[len++] = id;
+	for (size_t i = 0; i < nargs; i++) {
+		len += put_varint(&raw[len], args[i]);
+	}
+	raw[len] = crc8_ccitt(0, raw, len);
+	len++;
+
+	return cobs_encode(buf, raw, len);
+}
+
+size_t telemetry_encode_record(uint8_t *buf, size_t size, const struct telemetry_record *rec)
+{
+	uint32_t args[3] = {rec->led, rec->cnt, rec->coalesced};
+	uint8_t id = TELEMETRY_MSG_TOGGLE;
+
+	if (rec->coalesced > 0) {
+		if (rec->led < DELTA_LEDS) {
+			delta_state[rec->led].cnt = rec->cnt;
+		}
+		return telemetry_encode_msg(buf, size, TELEMETRY_MSG_TOGGLE_COALESCED, args, 3);
+	}
+
+	if (rec->led < DELTA_LEDS) {
+		/* Periodic keyframes let a reader that joined late, or lost a frame, recover. */
+		if (delta_state[rec->led].until_keyframe > 0) {
+			int32_t delta = (int32_t)(rec->cnt - delta_state[rec->led].cnt);
+
+			args[1] = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31); /* zigzag */
+			id = TELEMETRY_MSG_TOGGLE_DELTA;
+			delta_state[rec->led].until_keyframe--;
+		} else {
+			delta_state[rec->led].until_keyframe =
+				CONFIG_APP_TELEMETRY_BINARY_KEYFRAME_INTERVAL - 1;
+		}
+		delta_state[rec->led].cnt = rec->cnt;
+	}
+
+	return telemetry_encode_msg(buf, size, id, args, 2);
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_TELEMETRY_ENCODE_H_
+#define APP_TELEMETRY_ENCODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry.h"
+
+/* Compact binary telemetry, decoded on the host by scripts/telemetry_decode.py.
+ *
+ * Every message is a dictionary ID followed by unsigned LEB128 varint arguments and a CRC-8
+ * (CCITT) of both. The result is COBS-encoded and terminated with 0x00, so the stream contains no
+ * other zero bytes and a reader can resynchronize at the next 0x00 after any corruption.
+ *
+ * The host keeps the format string for each ID; keep the two tables in step.
+ */
+enum telemetry_msg_id {
+	/* "Toggled led{led}; counter={cnt}" */
+	TELEMETRY_MSG_TOGGLE = 1,
+	/* Same text; counter is the previous counter for this LED plus zigzag(delta). */
+	TELEMETRY_MSG_TOGGLE_DELTA = 2,
+	/* "uart: {lines} lines/s, {ns} ns/line" */
+	TELEMETRY_MSG_UART_STATS = 3,
+	/* "Toggled led{led}; counter={cnt} ({coalesced} coalesced)" */
+	TELEMETRY_MSG_TOGGLE_COALESCED = 4,
+	/* "led{led}: sent={} dropped={} nomem={} depth={depth}/{max_depth}", see telemetry_led_stats */
+	TELEMETRY_MSG_LED_STATS = 5,
+	/* "latency led{led} {stage}: n={} p50={}us p99={}us max={}us", stage as enum latency_stage */
+	TELEMETRY_MSG_LATENCY = 6,
+	/* "cpu thread{slot}: {permille / 10}.{permille % 10}% switches={}", see struct cpu_load */
+	TELEMETRY_MSG_CPU_LOAD = 7,
+	/* "leds: {} wakeups/s for {} toggles/s" */
+	TELEMETRY_MSG_LED_WAKEUPS = 8,
+	/* "boot: reset->main={}us main->configured={}us configured->toggle={}us" */
+	TELEMETRY_MSG_BOOT = 9,
+	/* "led{}: periods={} missed={} max_late={}us" */
+	TELEMETRY_MSG_LED_TIMING = 10,
+	/* "led_workq: depth={}/{} max_runtime={}us" */
+	TELEMETRY_MSG_LED_WORK = 11,
+	/* "scenario led{}: toggles={} max_gap={}ms" */
+	TELEMETRY_MSG_SCENARIO_LED = 12,
+	/* "scenario uart: p99={}us max={}us" */
+	TELEMETRY_MSG_SCENARIO_UART = 13,
+	/* "scenario {name}: led3 {} toggles/s" (name: enum led_scenario) */
+	TELEMETRY_MSG_SCENARIO_RATE = 14,
+	/* "probe: {} toggles/s ({}-{}), {}% taken" */
+	TELEMETRY_MSG_BUSY_PROBE = 15,
+	/* "led1 wake via {edge|events}: n={} avg={}us max={}us" (path: 1 edge, 0 events) */
+	TELEMETRY_MSG_LED1_WAKE = 16,
+	/* "button: n={} p50={}us p99={}us max={}us" */
+	TELEMETRY_MSG_BUTTON = 17,
+	/* "button {lo}-{hi}us: {presses}", one histogram bucket */
+	TELEMETRY_MSG_BUTTON_BUCKET = 18,
+};
+
+/* Largest frame telemetry_encode_msg() produces, including the delimiter. */
+#define TELEMETRY_FRAME_MAX 40
+
+/* Encode message @id with @nargs varint arguments into @buf. Returns the frame length, or 0 if
+ * @size is too small. */
+size_t telemetry_encode_msg(uint8_t *buf, size_t size, uint8_t id, const uint32_t *args,
+			    size_t nargs);
+
+/* Encode a toggle record, as a delta against the previous record for the same LED when possible.
+ * Not thread-safe: call from the single telemetry consumer. */
+size_t telemetry_encode_record(uint8_t *buf, size_t size, const struct telemetry_record *rec);
+
+#endif /* APP_TELEMETRY_ENCODE_H_ */
@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "telemetry_ring.h"
+
+void telemetry_ring_init(struct telemetry_ring *ring, struct telemetry_ring_slot *slots,
+			 uint32_t size, enum telemetry_ring_policy policy,
+			 telemetry_ring_evict_cb_t evict_cb)
+{
+	__ASSERT(IS_POWER_OF_TWO(size), "ring size must be a power of two");
+
+	ring->slots = slots;
+	ring->mask = size - 1;
+	ring->policy = policy;
+	ring->evict_cb = evict_cb;
+	atomic_set(&ring->head, 0);
+	atomic_set(&ring->tail, 0);
+	atomic_set(&ring->pending, 0);
+	atomic_set(&ring->max_used, 0);
+	atomic_set(&ring->dropped, 0);
+	atomic_set(&ring->space_waiters, 0);
+	atomic_set(&ring->consumer_waiting, 0);
+	k_sem_init(&ring->data, 0, 1);
+	k_sem_init(&ring->space, 0, size);
+
+	/* A slot is free for position p when seq == p, and full when seq == p + 1. */
+	for (uint32_t i = 0; i < size; i++) {
+		atomic_set(&slots[i].seq, i);
+	}
+}
+
+static bool try_enqueue(struct telemetry_ring *ring, const struct telemetry_record *rec)
+{
+	atomic_val_t pos = atomic_get(&ring->head);
+
+	while (1) {
+		struct telemetry_ring_slot *slot = &ring->slots[pos & ring->mask];
+		atomic_val_t dif = atomic_get(&slot->seq) - pos;
+
+		if (dif == 0) {
+			if (atomic_cas(&ring->head, pos, pos + 1)) {
+				slot->rec = *rec;
+				atomic_set(&slot->seq, pos + 1);
+				return true;
+			}
+			pos = atomic_get(&ring->head);
+		} else if (dif < 0) {
+			return false; /* full */
+		} else {
+			pos = atomic_get(&ring->head); /* another producer won the slot */
+		}
+	}
+}
+
+static bool try_dequeue(struct telemetry_ring *ring, struct telemetry_record *rec)
+{
+	atomic_val_t pos = atomic_get(&ring->tail);
+
+	while (1) {
+		struct telemetry_ring_slot *slot = &ring->slots[pos & ring->mask];
+		atomic_val_t dif = atomic_get(&slot->seq) - (pos + 1);
+
+		if (dif == 0) {
+			/* Producers evicting the oldest record also dequeue, so claim with a CAS. */
+			if (atomic_cas(&ring->tail, pos, pos + 1)) {
+				if (rec != NULL) {
+					*rec = slot->rec;
+				}
+				atomic_set(&slot->seq, pos + ring->mask + 1);
+				atomic_dec(&ring->pending);
+				if (atomic_get(&ring->space_waiters) > 0) {
+					k_sem_give(&ring->space);
+				}
+				return true;
+			}
+			pos = atomic_get(&ring->tail);
+		} else if (dif < 0) {
+			return false; /* empty */
+		} else {
+			pos = atomic_get(&ring->tail);
+		}
+	}
+}
+
+static void published(struct telemetry_ring *ring)
+{
+	atomic_val_t used = atomic_inc(&ring->pending) + 1;
+	atomic_val_t max = atomic_get(&ring->max_used);
+
+	/* pending lags the slots by a few instructions, so clamp it to the ring size. */
+	used = MIN(used, (atomic_val_t)ring->mask + 1);
+
+	while (used > max && !atomic_cas(&ring->max_used, max, used)) {
+		max = atomic_get(&ring->max_used);
+	}
+
+	/* Only wake the consumer if it drained the ring and went to sleep. */
+	if (atomic_cas(&ring->consumer_waiting, 1, 0)) {
+		k_sem_give(&ring->data);
+	}
+}
+
+int telemetry_ring_put(struct telemetry_ring *ring, const struct telemetry_record *rec,
+		       k_timeout_t timeout)
+{
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	struct telemetry_record evicted;
+	bool queued;
+
+	while (!try_enqueue(ring, rec)) {
+		if (ring->policy == TELEMETRY_RING_DROP_OLDEST) {
+			/* Full yet nothing to evict: a producer or the consumer we preempted holds
+			 * the slot between its CAS and its seq update, and can't finish until we
+			 * return. Retrying would spin forever, so drop this record instead. */
+			if (!try_dequeue(ring, &evicted)) {
+				atomic_inc(&ring->dropped);
+				return -ENOBUFS;
+			}
+			atomic_inc(&ring->dropped);
+			if (ring->evict_cb != NULL) {
+				ring->evict_cb(&evicted);
+			}
+			continue;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			atomic_inc(&ring->dropped);
+			return -ENOBUFS;
+		}
+
+		/* Register before re-checking so a slot freed in between still wakes us. */
+		atomic_inc(&ring->space_waiters);
+		queued = try_enqueue(ring, rec);
+		if (!queued && k_sem_take(&ring->space, sys_timepoint_timeout(end)) != 0) {
+			atomic_dec(&ring->space_waiters);
+			atomic_inc(&ring->dropped);
+			return -ENOBUFS;
+		}
+		atomic_dec(&ring->space_waiters);
+		if (queued) {
+			break;
+		}
+	}
+
+	published(ring);
+	return 0;
+}
+
+int telemetry_ring_get(struct telemetry_ring *ring, struct telemetry_record *rec,
+		       k_timeout_t timeout)
+{
+	while (!try_dequeue(ring, rec)) {
+		/* A producer may have claimed the head slot without filling it yet, so the ring can
+		 * look empty while later slots are full. Announce the sleep and look again; every
+		 * producer that publishes after the announcement will wake us. */
+		atomic_set(&ring->consumer_waiting, 1);
+		if (try_dequeue(ring, rec)) {
+			atomic_set(&ring->consumer_waiting, 0);
+			return 0;
+		}
+		/* On timeout the announcement stays up, so the next publish still gives ring->data
+		 * for a consumer that polls it instead. At worst that leaves a stale count, which
+		 * costs one extra pass around this loop. */
+		if (k_sem_take(&ring->data, timeout) != 0) {
+			return -EAGAIN;
+		}
+	}
+	return 0;
+}
+
+void telemetry_ring_poll_init(struct telemetry_ring *ring, struct k_poll_event *evt)
+{
+	k_poll_event_init(evt, K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &ring->data);
+}
+
+void telemetry_ring_stats_get(struct telemetry_ring *ring, struct telemetry_stats *stats)
+{
+	atomic_val_t used = atomic_get(&ring->pending);
+
+	stats->used = used > 0 ? used : 0;
+	stats->max_used = atomic_get(&ring->max_used);
+	stats->dropped = atomic_get(&ring->dropped);
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_TELEMETRY_RING_H_
+#define APP_TELEMETRY_RING_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "telemetry.h"
+
+/* Bounded multi-producer ring of telemetry records.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue), so producers claim slots with one
+ * compare-and-swap and never take a lock or enter the kernel. The consumer sleeps on a semaphore
+ * that is only given when the ring goes from empty to non-empty, i.e. when a producer finds the
+ * consumer asleep on a drained ring.
+ *
+ * Only a single consumer may call telemetry_ring_get().
+ */
+
+enum telemetry_ring_policy {
+	/* Wait up to the telemetry_ring_put() timeout for a free slot, then discard the record being
+	 * published. With K_NO_WAIT this never blocks; with K_FOREVER it never drops. */
+	TELEMETRY_RING_DROP_NEWEST,
+	/* Never wait: discard the oldest queued record to make room, or the record being published
+	 * if the oldest is still being written or read by a context this one preempted. */
+	TELEMETRY_RING_DROP_OLDEST,
+};
+
+/* Called from telemetry_ring_put() for each record evicted by TELEMETRY_RING_DROP_OLDEST. */
+typedef void (*telemetry_ring_evict_cb_t)(const struct telemetry_record *rec);
+
+struct telemetry_ring_slot {
+	atomic_t seq;
+	struct telemetry_record rec;
+};
+
+struct telemetry_ring {
+	struct telemetry_ring_slot *slots;
+	uint32_t mask;
+	enum telemetry_ring_policy policy;
+	telemetry_ring_evict_cb_t evict_cb;
+	atomic_t head;     /* next position to publish */
+	atomic_t tail;     /* next position to consume */
+	atomic_t pending;  /* published but not yet consumed */
+	atomic_t max_used;
+	atomic_t dropped;
+	atomic_t space_waiters;
+	atomic_t consumer_waiting;
+	struct k_sem data;  /* given on empty -> non-empty */
+	struct k_sem space; /* given when a slot frees up and a producer is blocked */
+};
+
+/* @size must be a power of two. @evict_cb may be NULL. */
+void telemetry_ring_init(struct telemetry_ring *ring, struct telemetry_ring_slot *slots,
+			 uint32_t size, enum telemetry_ring_policy policy,
+			 telemetry_ring_evict_cb_t evict_cb);
+
+/* Returns 0 if @rec was queued, -ENOBUFS if it was dropped. */
+int telemetry_ring_put(struct telemetry_ring *ring, const struct telemetry_record *rec,
+		       k_timeout_t timeout);
+
+/* Returns 0 and fills @rec, or -EAGAIN if nothing arrived before @timeout. */
+int telemetry_ring_get(struct telemetry_ring *ring, struct telemetry_record *rec,
+		       k_timeout_t timeout);
+
+/* Set up @evt to poll for records, for a consumer that waits on other things too. Once it is
+ * ready, call telemetry_ring_get() until it returns -EAGAIN before polling again; it may also be
+ * ready with nothing left to read. */
+void telemetry_ring_poll_init(struct telemetry_ring *ring, struct k_poll_event *evt);
+
+void telemetry_ring_stats_get(struct telemetry_ring *ring, struct telemetry_stats *stats);
+
+#endif /* APP_TELEMETRY_RING_H_ */
@@ -0,0 +1,16 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_THREADS_H_
+#define APP_THREADS_H_
+
+/* size of stack area used by each thread */
+#define STACKSIZE 1024
+
+/* scheduling priority used by each thread */
+#define PRIORITY_LEDS 7
+#define PRIORITY_UART 1
+#define PRIORITY_INIT 0
+
+#endif /* APP_THREADS_H_ */
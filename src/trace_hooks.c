@@ -0,0 +1,37 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/tracing/tracing_user.h>
+
+#include "button.h"
+#include "cpu_load.h"
+#include "sched_trace.h"
+
+/* The kernel's user tracing hooks (CONFIG_TRACING_USER). There is only one of each, so every
+ * module that needs one is called from here. They run with interrupts locked or in ISRs. */
+
+void sys_trace_thread_switched_in_user(void)
+{
+#ifdef CONFIG_APP_CPU_LOAD_SWITCHES
+	cpu_load_switched_in();
+#endif
+	sched_trace_record(SCHED_TRACE_SWITCH_IN, 0);
+}
+
+void sys_trace_thread_switched_out_user(void)
+{
+	sched_trace_record(SCHED_TRACE_SWITCH_OUT, 0);
+}
+
+void sys_trace_isr_enter_user(int nested_interrupts)
+{
+	button_isr_entered();
+	sched_trace_record(SCHED_TRACE_ISR_ENTER, nested_interrupts);
+}
+
+void sys_trace_isr_exit_user(int nested_interrupts)
+{
+	sched_trace_record(SCHED_TRACE_ISR_EXIT, nested_interrupts);
+}
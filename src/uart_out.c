@@ -0,0 +1,890 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdarg.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/printk.h>
+
+#include "boot_phase.h"
+#include "busy_probe.h"
+#include "button.h"
+#include "cpu_load.h"
+#include "latency.h"
+#include "leds.h"
+#include "telemetry.h"
+#include "telemetry_encode.h"
+#include "uart_out.h"
+
+/* Room for any one line uart_out() writes: a telemetry record or a report. Longer text lines are
+ * truncated. */
+#define LINE_MAX 80
+BUILD_ASSERT(TELEMETRY_FRAME_MAX <= LINE_MAX);
+
+static const struct device *const uart_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+
+#ifdef CONFIG_APP_UART_BATCH
+#define FLUSH_MS CONFIG_APP_UART_FLUSH_MS
+#else
+#define FLUSH_MS 0
+#endif
+
+/* See uart_out_configure(). uart_out() reads these afresh on every wakeup. */
+static atomic_t settings[UART_OUT_SETTINGS] = {
+	[UART_OUT_REPORTS] = ATOMIC_INIT(1),
+	[UART_OUT_FLUSH_MS] = ATOMIC_INIT(FLUSH_MS),
+};
+
+static bool __unused reports_on(void)
+{
+	return atomic_get(&settings[UART_OUT_REPORTS]) != 0;
+}
+
+/* snprintk() that returns the number of characters actually stored. */
+static int __unused format_text(char *buf, size_t size, const char *fmt, ...)
+{
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = vsnprintk(buf, size, fmt, ap);
+	va_end(ap);
+	return MIN(len, (int)size - 1);
+}
+
+static int format_record(char *buf, size_t size, const struct telemetry_record *rec)
+{
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	return telemetry_encode_record((uint8_t *)buf, size, rec);
+#else
+	if (rec->coalesced > 0) {
+		return format_text(buf, size, "Toggled led%d; counter=%d (%u coalesced)\n", rec->led,
+				   rec->cnt, rec->coalesced);
+	}
+	return format_text(buf, size, "Toggled led%d; counter=%d\n", rec->led, rec->cnt);
+#endif
+}
+
+static int format_stats(char *buf, size_t size, uint32_t lines_per_sec, uint32_t ns_per_line)
+{
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {lines_per_sec, ns_per_line};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_UART_STATS, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "uart: %u lines/s, %u ns/line\n", lines_per_sec,
+			   ns_per_line);
+#endif
+}
+
+static int __unused format_led_stats(char *buf, size_t size, uint32_t led,
+				     const struct telemetry_led_stats *st)
+{
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {led, st->published, st->dropped, st->alloc_failures, st->depth,
+			   st->max_depth};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_LED_STATS, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "led%u: sent=%u dropped=%u nomem=%u depth=%u/%u\n", led,
+			   st->published, st->dropped, st->alloc_failures, st->depth,
+			   st->max_depth);
+#endif
+}
+
+static int __unused format_latency(char *buf, size_t size, uint32_t led,
+				   enum latency_stage stage, const struct latency_summary *s)
+{
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {led, stage, s->count, s->p50_us, s->p99_us, s->max_us};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_LATENCY, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "latency led%u %s: n=%u p50=%uus p99=%uus max=%uus\n", led,
+			   latency_stage_name(stage), s->count, s->p50_us, s->p99_us, s->max_us);
+#endif
+}
+
+static int __unused format_cpu_load(char *buf, size_t size, uint32_t slot,
+				    const struct cpu_load *load)
+{
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {slot, load->permille, load->switches};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_CPU_LOAD, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "cpu %s: %u.%u%% switches=%u\n", load->name,
+			   load->permille / 10, load->permille % 10, load->switches);
+#endif
+}
+
+#define HAVE_REPORTS                                                                               \
+	(CONFIG_APP_TELEMETRY_SUMMARY_INTERVAL_MS > 0 || CONFIG_APP_LATENCY_REPORT_INTERVAL_MS > 0 ||  \
+	 CONFIG_APP_CPU_LOAD_REPORT_INTERVAL_MS > 0 ||                                             \
+	 CONFIG_APP_LED_WAKEUPS_REPORT_INTERVAL_MS > 0 ||                                          \
+	 CONFIG_APP_LED_TIMING_REPORT_INTERVAL_MS > 0 ||                                           \
+	 CONFIG_APP_SCENARIO_REPORT_INTERVAL_MS > 0 ||                                             \
+	 CONFIG_APP_BUSY_PROBE_REPORT_INTERVAL_MS > 0 ||                                           \
+	 CONFIG_APP_LED1_NOTIFY_REPORT_INTERVAL_MS > 0 ||                                          \
+	 CONFIG_APP_BUTTON_REPORT_INTERVAL_MS > 0 || IS_ENABLED(CONFIG_APP_BOOT_REPORT))
+
+#if HAVE_REPORTS
+/* Periodic reports. Each is written one line per uart_out() iteration, so reports interleave with
+ * telemetry instead of needing a buffer for every line at once. */
+struct report {
+	uint32_t interval_ms; /* 0: once, as soon as format() has something to say */
+	uint32_t lines;
+	int (*format)(char *buf, size_t size, uint32_t line);
+	int64_t due;
+	uint32_t next; /* next line to write; == lines while idle */
+};
+
+#if CONFIG_APP_TELEMETRY_SUMMARY_INTERVAL_MS > 0
+static int summary_line(char *buf, size_t size, uint32_t led)
+{
+	struct telemetry_led_stats st;
+
+	telemetry_led_stats_get(led, &st);
+	return format_led_stats(buf, size, led, &st);
+}
+#endif
+
+#if CONFIG_APP_LATENCY_REPORT_INTERVAL_MS > 0
+static int latency_line(char *buf, size_t size, uint32_t line)
+{
+	uint32_t led = line / LATENCY_STAGES;
+	enum latency_stage stage = line % LATENCY_STAGES;
+	struct latency_summary s;
+
+	latency_summary_get(stage, led, &s);
+	return format_latency(buf, size, led, stage, &s);
+}
+#endif
+
+#if CONFIG_APP_CPU_LOAD_REPORT_INTERVAL_MS > 0
+static int cpu_load_line(char *buf, size_t size, uint32_t slot)
+{
+	struct cpu_load load;
+
+	if (cpu_load_get(slot, &load) != 0) {
+		return 0;
+	}
+	return format_cpu_load(buf, size, slot, &load);
+}
+#endif
+
+#if CONFIG_APP_LED_WAKEUPS_REPORT_INTERVAL_MS > 0
+static int led_wakeups_line(char *buf, size_t size, uint32_t line)
+{
+	static uint32_t last_wakeups, last_steps;
+	static int64_t since;
+	uint32_t wakeups = led_wakeups_get();
+	uint32_t steps = led_steps_get();
+	int64_t now = k_uptime_get();
+	uint32_t rates[2] = {0, 0}; /* wakeups/s, toggles/s */
+
+	if (now > since) {
+		rates[0] = (uint64_t)(wakeups - last_wakeups) * MSEC_PER_SEC / (now - since);
+		rates[1] = (uint64_t)(steps - last_steps) * MSEC_PER_SEC / (now - since);
+	}
+	last_wakeups = wakeups;
+	last_steps = steps;
+	since = now;
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_LED_WAKEUPS, rates,
+				    ARRAY_SIZE(rates));
+#else
+	return format_text(buf, size, "leds: %u wakeups/s for %u toggles/s\n", rates[0], rates[1]);
+#endif
+}
+#endif
+
+#if CONFIG_APP_LED_TIMING_REPORT_INTERVAL_MS > 0
+/* One line per LED with deadline statistics, then the workqueue statistics if there are any. */
+static int led_timing_line(char *buf, size_t size, uint32_t line)
+{
+	struct period_stats st;
+	struct led_work_stats work;
+
+	if (line < CONFIG_APP_TELEMETRY_MAX_LEDS) {
+		uint32_t max_late_us;
+
+		if (led_period_stats_get(line, &st) != 0 || st.periods == 0) {
+			return 0;
+		}
+		max_late_us = k_ticks_to_us_floor32(MAX(st.max_late_ticks, 0));
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+		uint32_t args[] = {line, st.periods, st.missed, max_late_us};
+
+		return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_LED_TIMING, args,
+					    ARRAY_SIZE(args));
+#else
+		return format_text(buf, size, "led%u: periods=%u missed=%u max_late=%uus\n", line,
+				   st.periods, st.missed, max_late_us);
+#endif
+	}
+
+	if (led_work_stats_get(&work) != 0) {
+		return 0;
+	}
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {work.depth, work.max_depth, work.max_runtime_us};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_LED_WORK, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "led_workq: depth=%u/%u max_runtime=%uus\n", work.depth,
+			   work.max_depth, work.max_runtime_us);
+#endif
+}
+#endif
+
+#if CONFIG_APP_SCENARIO_REPORT_INTERVAL_MS > 0
+#define SCENARIO_BUSY_LED 3
+
+/* LED0-LED2's toggles and longest gaps, the worst dequeue latency of any LED (with
+ * CONFIG_APP_LATENCY), and last the busy LED3's toggle rate. */
+static int scenario_line(char *buf, size_t size, uint32_t line)
+{
+	struct led_activity act;
+
+	if (line < SCENARIO_BUSY_LED) {
+		led_activity_get(line, &act);
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+		uint32_t args[] = {line, act.toggles, act.max_gap_ms};
+
+		return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_SCENARIO_LED, args,
+					    ARRAY_SIZE(args));
+#else
+		return format_text(buf, size, "scenario led%u: toggles=%u max_gap=%ums\n", line,
+				   act.toggles, act.max_gap_ms);
+#endif
+	}
+
+	if (line == SCENARIO_BUSY_LED) {
+#ifdef CONFIG_APP_LATENCY
+		struct latency_summary s;
+		uint32_t p99_us = 0, max_us = 0;
+
+		for (uint32_t led = 0; led < CONFIG_APP_TELEMETRY_MAX_LEDS; led++) {
+			if (latency_summary_get(LATENCY_DEQUEUE, led, &s) == 0) {
+				p99_us = MAX(p99_us, s.p99_us);
+				max_us = MAX(max_us, s.max_us);
+			}
+		}
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+		uint32_t args[] = {p99_us, max_us};
+
+		return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_SCENARIO_UART,
+					    args, ARRAY_SIZE(args));
+#else
+		return format_text(buf, size, "scenario uart: p99=%uus max=%uus\n", p99_us,
+				   max_us);
+#endif
+#else
+		return 0;
+#endif
+	}
+
+	static uint32_t last;
+	static int64_t since;
+	int64_t now = k_uptime_get();
+	uint32_t rate;
+
+	led_activity_get(SCENARIO_BUSY_LED, &act);
+	rate = now > since ? (uint32_t)((uint64_t)(act.toggles - last) * MSEC_PER_SEC / (now - since))
+			   : 0;
+	last = act.toggles;
+	since = now;
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {led_scenario_id(), rate};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_SCENARIO_RATE, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "scenario %s: led3 %u toggles/s\n", led_scenario_name(),
+			   rate);
+#endif
+}
+#endif
+
+#if CONFIG_APP_BUSY_PROBE_REPORT_INTERVAL_MS > 0
+static int busy_probe_line(char *buf, size_t size, uint32_t line)
+{
+	struct busy_probe_summary s;
+
+	busy_probe_summary_get(&s);
+	if (s.samples == 0) {
+		return 0;
+	}
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {s.avg, s.min, s.max, s.taken_pct};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_BUSY_PROBE, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "probe: %u toggles/s (%u-%u), %u%% taken\n", s.avg, s.min,
+			   s.max, s.taken_pct);
+#endif
+}
+#endif
+
+#if CONFIG_APP_LED1_NOTIFY_REPORT_INTERVAL_MS > 0
+static int led1_wake_line(char *buf, size_t size, uint32_t line)
+{
+	struct led1_wake_stats st;
+
+	led1_wake_stats_get(&st);
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {IS_ENABLED(CONFIG_APP_LED1_NOTIFY_EDGE), st.count, st.avg_us, st.max_us};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_LED1_WAKE, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "led1 wake via %s: n=%u avg=%uus max=%uus\n", st.path,
+			   st.count, st.avg_us, st.max_us);
+#endif
+}
+#endif
+
+#if CONFIG_APP_BUTTON_REPORT_INTERVAL_MS > 0
+/* The summary, then one line per non-empty histogram bucket, all from the snapshot taken for the
+ * summary. */
+static int button_line(char *buf, size_t size, uint32_t line)
+{
+	static struct latency_histogram h;
+	uint32_t lo_us, hi_us;
+
+	if (line == 0) {
+		struct latency_summary s;
+
+		button_latency_get(&h);
+		latency_histogram_summarize(&h, &s);
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+		uint32_t args[] = {s.count, s.p50_us, s.p99_us, s.max_us};
+
+		return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_BUTTON, args,
+					    ARRAY_SIZE(args));
+#else
+		return format_text(buf, size, "button: n=%u p50=%uus p99=%uus max=%uus\n", s.count,
+				   s.p50_us, s.p99_us, s.max_us);
+#endif
+	}
+
+	if (h.buckets[line - 1] == 0) {
+		return 0;
+	}
+	latency_bucket_bounds(line - 1, &lo_us, &hi_us);
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {lo_us, hi_us, h.buckets[line - 1]};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_BUTTON_BUCKET, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size, "button %u-%uus: %u\n", lo_us, hi_us, h.buckets[line - 1]);
+#endif
+}
+#endif
+
+#ifdef CONFIG_APP_BOOT_REPORT
+static int boot_line(char *buf, size_t size, uint32_t line)
+{
+	uint32_t main_us, configured_us, toggle_us;
+
+	if (!boot_phase_us(BOOT_PHASE_MAIN, &main_us) ||
+	    !boot_phase_us(BOOT_PHASE_CONFIGURED, &configured_us) ||
+	    !boot_phase_us(BOOT_PHASE_FIRST_TOGGLE, &toggle_us)) {
+		return 0;
+	}
+#ifdef CONFIG_APP_TELEMETRY_FORMAT_BINARY
+	uint32_t args[] = {main_us, configured_us - main_us, toggle_us - configured_us};
+
+	return telemetry_encode_msg((uint8_t *)buf, size, TELEMETRY_MSG_BOOT, args,
+				    ARRAY_SIZE(args));
+#else
+	return format_text(buf, size,
+			   "boot: reset->main=%uus main->configured=%uus configured->toggle=%uus\n",
+			   main_us, configured_us - main_us, toggle_us - configured_us);
+#endif
+}
+#endif
+
+static struct report reports[] = {
+#ifdef CONFIG_APP_BOOT_REPORT
+	{
+		.lines = 1,
+		.format = boot_line,
+	},
+#endif
+#if CONFIG_APP_TELEMETRY_SUMMARY_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_TELEMETRY_SUMMARY_INTERVAL_MS,
+		.lines = CONFIG_APP_TELEMETRY_MAX_LEDS,
+		.format = summary_line,
+		.next = CONFIG_APP_TELEMETRY_MAX_LEDS,
+	},
+#endif
+#if CONFIG_APP_LATENCY_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_LATENCY_REPORT_INTERVAL_MS,
+		.lines = CONFIG_APP_TELEMETRY_MAX_LEDS * LATENCY_STAGES,
+		.format = latency_line,
+		.next = CONFIG_APP_TELEMETRY_MAX_LEDS * LATENCY_STAGES,
+	},
+#endif
+#if CONFIG_APP_CPU_LOAD_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_CPU_LOAD_REPORT_INTERVAL_MS,
+		.lines = CONFIG_APP_CPU_LOAD_MAX_THREADS,
+		.format = cpu_load_line,
+		.next = CONFIG_APP_CPU_LOAD_MAX_THREADS,
+	},
+#endif
+#if CONFIG_APP_LED_WAKEUPS_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_LED_WAKEUPS_REPORT_INTERVAL_MS,
+		.lines = 1,
+		.format = led_wakeups_line,
+		.next = 1,
+	},
+#endif
+#if CONFIG_APP_LED_TIMING_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_LED_TIMING_REPORT_INTERVAL_MS,
+		.lines = CONFIG_APP_TELEMETRY_MAX_LEDS + 1,
+		.format = led_timing_line,
+		.next = CONFIG_APP_TELEMETRY_MAX_LEDS + 1,
+	},
+#endif
+#if CONFIG_APP_SCENARIO_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_SCENARIO_REPORT_INTERVAL_MS,
+		.lines = SCENARIO_BUSY_LED + 2,
+		.format = scenario_line,
+		.next = SCENARIO_BUSY_LED + 2,
+	},
+#endif
+#if CONFIG_APP_BUSY_PROBE_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_BUSY_PROBE_REPORT_INTERVAL_MS,
+		.lines = 1,
+		.format = busy_probe_line,
+		.next = 1,
+	},
+#endif
+#if CONFIG_APP_LED1_NOTIFY_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_LED1_NOTIFY_REPORT_INTERVAL_MS,
+		.lines = 1,
+		.format = led1_wake_line,
+		.next = 1,
+	},
+#endif
+#if CONFIG_APP_BUTTON_REPORT_INTERVAL_MS > 0
+	{
+		.interval_ms = CONFIG_APP_BUTTON_REPORT_INTERVAL_MS,
+		.lines = LATENCY_BUCKETS + 1,
+		.format = button_line,
+		.next = LATENCY_BUCKETS + 1,
+	},
+#endif
+};
+
+/* Returns the next line of whichever report is in progress or due, or 0 if none is. */
+static int report_format(char *buf, size_t size)
+{
+	int64_t now = k_uptime_get();
+
+	if (!reports_on()) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		struct report *r = &reports[i];
+
+		if (r->interval_ms == 0) {
+			int len = r->next < r->lines ? r->format(buf, size, r->next) : 0;
+
+			if (len > 0) {
+				r->next++;
+				return len;
+			}
+			continue;
+		}
+		if (r->next >= r->lines) {
+			if (now < r->due) {
+				continue;
+			}
+			r->due = MAX(r->due + r->interval_ms, now);
+			r->next = 0;
+		}
+		return r->format(buf, size, r->next++);
+	}
+	return 0;
+}
+
+/* Uptime (ms) by which uart_out() must wake for the next report line, or INT64_MAX for never. */
+static int64_t report_due(void)
+{
+	int64_t due = INT64_MAX;
+
+	if (!reports_on()) {
+		return INT64_MAX;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		if (reports[i].interval_ms == 0) {
+			continue; /* checked whenever uart_out() wakes anyway */
+		}
+		if (reports[i].next < reports[i].lines) {
+			return 0;
+		}
+		due = MIN(due, reports[i].due);
+	}
+	return due;
+}
+#else
+#define report_format(buf, size) 0
+#define report_due()             INT64_MAX
+#endif /* HAVE_REPORTS */
+
+/* Blocking write. Unlike printk(), this passes zero bytes through. */
+static void write_raw(const char *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, buf[i]);
+	}
+}
+
+/* Binary frames end with 0x00. Send one up front so the boot banner and anything else printed
+ * before uart_out() started reaches the decoder as its own chunk. */
+static void stream_start(void)
+{
+	if (IS_ENABLED(CONFIG_APP_TELEMETRY_FORMAT_BINARY)) {
+		uart_poll_out(uart_dev, 0);
+	}
+}
+
+#ifdef CONFIG_APP_UART_STATS
+#include <zephyr/timing/timing.h>
+
+/* Lines written and CPU time spent producing them (formatting plus handing them to the driver,
+ * but not time spent asleep waiting for the UART) over the current reporting interval. */
+static struct {
+	uint32_t lines;
+	uint64_t cycles;
+	int64_t since;
+} stats;
+
+static void stats_account(uint32_t lines, timing_t *start)
+{
+	timing_t end = timing_counter_get();
+
+	stats.lines += lines;
+	stats.cycles += timing_cycles_get(start, &end);
+}
+
+/* Returns a report line once per interval, or 0 if it isn't due yet. */
+static int stats_format(char *buf, size_t size)
+{
+	int64_t elapsed = k_uptime_get() - stats.since;
+	int len;
+
+	if (elapsed < CONFIG_APP_UART_STATS_INTERVAL_MS || !reports_on()) {
+		return 0;
+	}
+
+	len = format_stats(
+		buf, size, (uint32_t)(stats.lines * MSEC_PER_SEC / elapsed),
+		stats.lines ? (uint32_t)(timing_cycles_to_ns(stats.cycles) / stats.lines) : 0);
+	stats.lines = 0;
+	stats.cycles = 0;
+	stats.since = k_uptime_get();
+	return len;
+}
+
+static int64_t stats_due(void)
+{
+	return reports_on() ? stats.since + CONFIG_APP_UART_STATS_INTERVAL_MS : INT64_MAX;
+}
+
+static void stats_init(void)
+{
+	timing_init();
+	timing_start();
+	stats.since = k_uptime_get();
+}
+#define STATS_START(t) timing_t t = timing_counter_get()
+#else
+#define stats_init()                (void)0
+#define stats_account(lines, start) ARG_UNUSED(lines)
+#define stats_format(buf, size)     0
+#define stats_due()                 INT64_MAX
+#define STATS_START(t)              (void)0
+#endif /* CONFIG_APP_UART_STATS */
+
+/* Everything uart_out() sleeps on between writes, at once, so a single thread serves the telemetry
+ * queue, LED1, the flush deadline, the reports and uart_out_configure(). */
+enum {
+	WAKE_DATA,    /* telemetry may be queued */
+	WAKE_LED1,    /* LED1 changed */
+	WAKE_CONTROL, /* a setting changed */
+	WAKE_SOURCES,
+};
+
+static struct k_poll_event wake_events[WAKE_SOURCES];
+static struct k_poll_signal control = K_POLL_SIGNAL_INITIALIZER(control);
+
+static void wake_init(void)
+{
+	telemetry_poll_init(&wake_events[WAKE_DATA]);
+	led1_poll_init(&wake_events[WAKE_LED1]);
+	k_poll_event_init(&wake_events[WAKE_CONTROL], K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+			  &control);
+}
+
+/* Sleep until a wake source fires or uptime reaches @due (ms). Returns the sources that fired as
+ * a bitmask of BIT(WAKE_*), or 0 once @due has passed. Only call this with the telemetry queue
+ * drained: some transports only signal it going from empty to non-empty. */
+static uint32_t wake_wait(int64_t due)
+{
+	uint32_t woke = 0;
+
+	due = MIN(due, stats_due());
+	for (size_t i = 0; i < ARRAY_SIZE(wake_events); i++) {
+		wake_events[i].state = K_POLL_STATE_NOT_READY;
+	}
+	(void)k_poll(wake_events, ARRAY_SIZE(wake_events),
+		     due == INT64_MAX ? K_FOREVER : K_TIMEOUT_ABS_MS(due));
+
+	for (size_t i = 0; i < ARRAY_SIZE(wake_events); i++) {
+		if (wake_events[i].state == K_POLL_STATE_NOT_READY) {
+			continue;
+		}
+		woke |= BIT(i);
+		// Reset before acting on it, so a raise from here on wakes the next k_poll().
+		if (wake_events[i].type == K_POLL_TYPE_SIGNAL) {
+			k_poll_signal_reset(wake_events[i].signal);
+		}
+	}
+	return woke;
+}
+
+int uart_out_configure(enum uart_out_setting setting, uint32_t value)
+{
+	if (setting >= UART_OUT_SETTINGS) {
+		return -EINVAL;
+	}
+	if (setting == UART_OUT_FLUSH_MS && !IS_ENABLED(CONFIG_APP_UART_BATCH)) {
+		return -ENOTSUP;
+	}
+
+	atomic_set(&settings[setting], value);
+	k_poll_signal_raise(&control, setting);
+	return 0;
+}
+
+#ifdef CONFIG_APP_LATENCY
+#define latency_dequeued(rec) latency_record(LATENCY_DEQUEUE, (rec)->led, (rec)->stamp)
+#define latency_sent(rec)     latency_record(LATENCY_TX_DONE, (rec)->led, (rec)->stamp)
+#else
+#define latency_dequeued(rec) (void)0
+#define latency_sent(rec)     (void)0
+#endif
+
+#ifdef CONFIG_APP_UART_BATCH
+
+/* One buffer is formatted while the other is on the wire. */
+static char tx_buf[2][CONFIG_APP_UART_BATCH_BUF_SIZE];
+BUILD_ASSERT(CONFIG_APP_UART_BATCH_BUF_SIZE >= 3 * LINE_MAX, "batch buffer too small");
+
+/* Given when the transfer in flight completes, so its buffer may be reused. */
+static K_SEM_DEFINE(tx_idle, 1, 1);
+static bool tx_async;
+
+#ifdef CONFIG_APP_LATENCY
+/* The records in each buffer, timed when the transfer carrying them completes. A binary record is
+ * at least 6 bytes, so a buffer can't hold more than this. */
+#define TX_RECS_MAX (CONFIG_APP_UART_BATCH_BUF_SIZE / 6)
+
+static struct {
+	uint32_t led;
+	uint32_t stamp;
+} tx_recs[2][TX_RECS_MAX];
+static uint32_t tx_nrecs[2];
+
+/* Safe once tx_idle has been taken since @idx was last sent. */
+static void tx_recs_reset(uint8_t idx)
+{
+	tx_nrecs[idx] = 0;
+}
+
+static void tx_recs_add(uint8_t idx, const struct telemetry_record *rec)
+{
+	if (tx_nrecs[idx] < TX_RECS_MAX) {
+		tx_recs[idx][tx_nrecs[idx]].led = rec->led;
+		tx_recs[idx][tx_nrecs[idx]].stamp = rec->stamp;
+		tx_nrecs[idx]++;
+	}
+}
+
+static void tx_recs_done(const char *buf)
+{
+	uint8_t idx = buf == tx_buf[1];
+
+	for (uint32_t i = 0; i < tx_nrecs[idx]; i++) {
+		latency_record(LATENCY_TX_DONE, tx_recs[idx][i].led, tx_recs[idx][i].stamp);
+	}
+}
+#else
+#define tx_recs_reset(idx)    (void)0
+#define tx_recs_add(idx, rec) (void)0
+#define tx_recs_done(buf)     (void)0
+#endif /* CONFIG_APP_LATENCY */
+
+static void uart_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+	switch (evt->type) {
+	case UART_TX_DONE:
+		tx_recs_done((const char *)evt->data.tx.buf);
+		k_sem_give(&tx_idle);
+		break;
+	case UART_TX_ABORTED:
+		k_sem_give(&tx_idle);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Call with tx_idle taken. Returns once @buf is queued; the other buffer is then free to fill. */
+static void uart_write(const char *buf, size_t len)
+{
+	if (tx_async && uart_tx(uart_dev, (const uint8_t *)buf, len, SYS_FOREVER_US) == 0) {
+		return;
+	}
+
+	// No async support (or the driver refused): fall back to one blocking write of the batch.
+	write_raw(buf, len);
+	tx_recs_done(buf);
+	k_sem_give(&tx_idle);
+}
+
+/* Room left in a batch buffer holding @len bytes, less the two report lines after the last
+ * record. */
+static size_t batch_room(size_t len)
+{
+	return sizeof(tx_buf[0]) - len - MIN(sizeof(tx_buf[0]) - len, 2 * LINE_MAX);
+}
+
+void uart_out(void)
+{
+	struct telemetry_record rec;
+	uint8_t idx = 0;
+	size_t len = 0;     /* bytes waiting in tx_buf[idx] */
+	int64_t opened = 0; /* uptime when the first of them was added */
+	bool drained = true;
+
+	tx_async = uart_callback_set(uart_dev, uart_cb, NULL) == 0;
+	stats_init();
+	stream_start();
+	wake_init();
+
+	while (1) {
+		int64_t flush_due =
+			len > 0 ? opened + (uint32_t)atomic_get(&settings[UART_OUT_FLUSH_MS])
+				: INT64_MAX;
+		// A batch sent because it was full may have left records behind: go straight back
+		// for them.
+		uint32_t woke = drained ? wake_wait(MIN(flush_due, report_due())) : 0;
+
+		STATS_START(start);
+		char *buf = tx_buf[idx];
+		size_t start_len = len;
+		uint32_t lines = 0;
+
+		if (len == 0) {
+			// This buffer's last transfer completed before the other buffer was sent.
+			tx_recs_reset(idx);
+		}
+
+		// Drain everything pending into one buffer, keeping room for the report lines.
+		drained = false;
+		while (batch_room(len) >= LINE_MAX) {
+			if (telemetry_get(&rec, K_NO_WAIT) != 0) {
+				drained = true;
+				break;
+			}
+			latency_dequeued(&rec);
+			len += format_record(&buf[len], sizeof(tx_buf[0]) - len, &rec);
+			tx_recs_add(idx, &rec);
+			lines++;
+		}
+
+		len += stats_format(&buf[len], sizeof(tx_buf[0]) - len);
+		len += report_format(&buf[len], sizeof(tx_buf[0]) - len);
+		stats_account(lines, &start);
+		if (len == 0) {
+			continue;
+		}
+		if (start_len == 0) {
+			opened = k_uptime_get();
+			flush_due = opened + (uint32_t)atomic_get(&settings[UART_OUT_FLUSH_MS]);
+		}
+
+		// Hold the batch for more records until its deadline, unless it is full or LED1 (the
+		// LED the others follow) changed and the host should see that now.
+		if (drained && batch_room(len) >= LINE_MAX && !(woke & BIT(WAKE_LED1)) &&
+		    k_uptime_get() < flush_due) {
+			continue;
+		}
+
+		// Sleep until the other buffer is off the wire; that wait isn't CPU time.
+		k_sem_take(&tx_idle, K_FOREVER);
+		STATS_START(submit);
+		uart_write(buf, len);
+		stats_account(0, &submit);
+		idx ^= 1;
+		len = 0;
+	}
+}
+
+#else
+
+void uart_out(void)
+{
+	struct telemetry_record rx_data;
+	char line[LINE_MAX];
+
+	stats_init();
+	stream_start();
+	wake_init();
+
+	while (1) {
+		// Every record is written as soon as it is read, so there is no batch for LED1 or a
+		// flush deadline to hurry along: only sleep once the queue is drained.
+		int ret = telemetry_get(&rx_data, K_NO_WAIT);
+
+		if (ret == 0) {
+			latency_dequeued(&rx_data);
+			STATS_START(start);
+			write_raw(line, format_record(line, sizeof(line), &rx_data));
+			stats_account(1, &start);
+			latency_sent(&rx_data);
+		}
+
+		write_raw(line, stats_format(line, sizeof(line)));
+		write_raw(line, report_format(line, sizeof(line)));
+		if (ret != 0) {
+			(void)wake_wait(report_due());
+		}
+	}
+}
+
+#endif /* CONFIG_APP_UART_BATCH */
@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef APP_UART_OUT_H_
+#define APP_UART_OUT_H_
+
+#include <stdint.h>
+
+/* UART helper thread entry point. Separating UART into a separate task allows printk() to run at
+ * higher or lower priority, as desired. */
+void uart_out(void);
+
+enum uart_out_setting {
+	/* 0 holds back the periodic reports (including the uart: statistics) until set to 1 again.
+	 * Defaults to 1. */
+	UART_OUT_REPORTS,
+	/* Longest a record may wait in a batch for more to join it, in ms. 0 sends each batch as
+	 * soon as the queue is drained. Defaults to CONFIG_APP_UART_FLUSH_MS; batch mode only. */
+	UART_OUT_FLUSH_MS,
+	UART_OUT_SETTINGS,
+};
+
+/* Change a setting at runtime, from any thread or ISR; uart_out() wakes to apply it. Returns 0,
+ * -EINVAL for an unknown setting, or -ENOTSUP if the setting doesn't apply to this build. */
+int uart_out_configure(enum uart_out_setting setting, uint32_t value);
+
+#endif /* APP_UART_OUT_H_ */
@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "bench.h"
+#include "threads.h"
+
+/* The application's two ways of moving LED state, side by side in the kernel benchmark image:
+ * "fifo" publishes LED1 with k_event_set_masked() and queues a slab node on a k_fifo for the
+ * consumer, as the default CONFIG_APP_TELEMETRY_FIFO build does; "zbus" publishes on a channel
+ * whose listener sets the same event bit for LED1 and whose message subscriber feeds the consumer,
+ * as CONFIG_APP_TELEMETRY_ZBUS does. N publisher threads at PRIORITY_LEDS share the messages, and
+ * the benchmark thread at PRIORITY_UART receives them all. Results, e.g. for 4 publishers:
+ *
+ *   zbus_n4_fifo_throughput   first publish to last receive, per message
+ *   zbus_n4_fifo_latency      publish to receive, per message
+ *   zbus_n4_fifo_latency_max  worst publish to receive
+ */
+
+#define MAX_PUBLISHERS 64
+#define POOL_SIZE      16
+#define BENCH_LED1_ON  BIT(0)
+
+struct bench_msg {
+	uint32_t led;
+	uint32_t cnt;
+	timing_t stamp; /* just before publishing */
+};
+
+struct bench_node {
+	void *fifo_reserved;
+	struct bench_msg msg;
+};
+
+static const uint32_t counts[] = {4, MAX_PUBLISHERS};
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_PUBLISHERS, CONFIG_APP_BENCH_ZBUS_STACK_SIZE);
+static struct k_thread threads[MAX_PUBLISHERS];
+
+static K_EVENT_DEFINE(events);
+
+K_MEM_SLAB_DEFINE_STATIC(slab, sizeof(struct bench_node), POOL_SIZE, sizeof(void *));
+static K_FIFO_DEFINE(fifo);
+
+static void led1_listener_cb(const struct zbus_channel *chan)
+{
+	const struct bench_msg *msg = zbus_chan_const_msg(chan);
+
+	if (msg->led == 1) {
+		k_event_set_masked(&events, (msg->cnt % 2) ? BENCH_LED1_ON : 0, BENCH_LED1_ON);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(bench_listener, led1_listener_cb);
+ZBUS_MSG_SUBSCRIBER_DEFINE(bench_sub);
+ZBUS_CHAN_DEFINE(bench_chan, struct bench_msg, NULL, NULL,
+		 ZBUS_OBSERVERS(bench_listener, bench_sub), ZBUS_MSG_INIT(0));
+
+static void fifo_publisher(void *p1, void *p2, void *p3)
+{
+	uint32_t led = (uintptr_t)p1;
+	uint32_t n = (uintptr_t)p2;
+
+	for (uint32_t cnt = 0; cnt < n; cnt++) {
+		timing_t stamp = timing_counter_get();
+		struct bench_node *node;
+
+		if (led == 1) {
+			k_event_set_masked(&events, (cnt % 2) ? BENCH_LED1_ON : 0, BENCH_LED1_ON);
+		}
+		(void)k_mem_slab_alloc(&slab, (void **)&node, K_FOREVER);
+		node->msg.led = led;
+		node->msg.cnt = cnt;
+		node->msg.stamp = stamp;
+		k_fifo_put(&fifo, node);
+	}
+}
+
+static void zbus_publisher(void *p1, void *p2, void *p3)
+{
+	uint32_t led = (uintptr_t)p1;
+	uint32_t n = (uintptr_t)p2;
+
+	for (uint32_t cnt = 0; cnt < n; cnt++) {
+		struct bench_msg msg = {.led = led, .cnt = cnt, .stamp = timing_counter_get()};
+
+		// Out of message buffers the consumer misses the message but the listener has already
+		// seen it. The benchmark waits for every message, so publish it again.
+		while (zbus_chan_pub(&bench_chan, &msg, K_FOREVER) == -ENOMEM) {
+			k_yield();
+		}
+	}
+}
+
+static void fifo_receive(struct bench_msg *msg)
+{
+	struct bench_node *node = k_fifo_get(&fifo, K_FOREVER);
+
+	*msg = node->msg;
+	k_mem_slab_free(&slab, node);
+}
+
+static void zbus_receive(struct bench_msg *msg)
+{
+	const struct zbus_channel *chan;
+
+	(void)zbus_sub_wait_msg(&bench_sub, &chan, msg, K_FOREVER);
+}
+
+static void result(uint32_t n, const char *path, const char *what, uint32_t ops, uint64_t cycles)
+{
+	char name[48];
+
+	snprintk(name, sizeof(name), "zbus_n%u_%s_%s", n, path, what);
+	bench_report(name, ops, cycles);
+}
+
+static void run(uint32_t n, uint32_t iterations, const char *path, k_thread_entry_t publisher,
+		void (*receive)(struct bench_msg *msg))
+{
+	uint32_t each = DIV_ROUND_UP(iterations, n);
+	uint64_t latency = 0;
+	uint64_t max = 0;
+	timing_t start, end;
+
+	// Create them all before starting any, so thread creation stays out of the throughput.
+	for (uint32_t i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], K_THREAD_STACK_SIZEOF(stacks[i]), publisher,
+				(void *)(uintptr_t)i, (void *)(uintptr_t)each, NULL, PRIORITY_LEDS,
+				0, K_FOREVER);
+	}
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < n; i++) {
+		k_thread_start(&threads[i]);
+	}
+	for (uint32_t i = 0; i < n * each; i++) {
+		struct bench_msg msg;
+		timing_t now;
+		uint64_t cycles;
+
+		receive(&msg);
+		now = timing_counter_get();
+		cycles = timing_cycles_get(&msg.stamp, &now);
+		latency += cycles;
+		max = MAX(max, cycles);
+	}
+	end = timing_counter_get();
+
+	for (uint32_t i = 0; i < n; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	result(n, path, "throughput", n * each, timing_cycles_get(&start, &end));
+	result(n, path, "latency", n * each, latency);
+	result(n, path, "latency_max", 1, max);
+}
+
+void zbus_bench(uint32_t iterations)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(counts); i++) {
+		run(counts[i], iterations, "fifo", fifo_publisher, fifo_receive);
+		run(counts[i], iterations, "zbus", zbus_publisher, zbus_receive);
+	}
+}